@@ -114,13 +114,14 @@ public:
             
             // Update terminal size
             updateTerminalSize();
+            windows.setScreen(term_width, term_height);
             if (buffer) {
                 delete buffer;
                 buffer = new UnicodeBuffer(term_width, term_height);
             }
             
             buffer->clear();
-            drawBackground();
+            fillBackground();
             
             // Update and draw menus first (so they appear on top)
             // Track which menu was just opened to close others
@@ -158,33 +159,12 @@ public:
             // Adjust menu positions to prevent overlap (simplified since only one menu can be open)
             DropdownMenu::adjustMenuPositions(menus, term_width);
             
-            // Update windows
-            for (auto& window : windows) {
-                window->active = false;
-            }
-            
-            // Update windows in reverse order (top window gets priority)
-            for (int i = windows.size() - 1; i >= 0; i--) {
-                if (windows[i]->isVisible()) {
-                    windows[i]->updateMouse(mouse, term_width, term_height);
-                    if (windows[i]->dragging || windows[i]->resizing) {
-                        windows[i]->active = true;
-                        // Move active window to front
-                        if (i != windows.size() - 1) {
-                            auto temp = windows[i];
-                            windows.erase(windows.begin() + i);
-                            windows.push_back(temp);
-                        }
-                        break;
-                    }
-                }
-            }
+            // Mouse handling for the visible windows, top first
+            updateWindows();
             
             // Draw all visible windows
-            for (auto& window : windows) {
-                if (window->isVisible()) {
-                    window->draw(*buffer);
-                }
+            for (WindowManager::Handle h = windows.bottomLive(); h; h = windows.liveAbove(h)) {
+                windows.get(h)->draw(*buffer);
             }
             
             // Draw horizontal menu bar background first
@@ -1,19 +1,50 @@
 #include "../include/asm_optimized.h"
 #include "../include/buffer.h"
+#include "../include/mouse_handler.h"
+#include "../include/terminal_output.h"
+#include "../include/event_system.h"
+#include "../include/hit_index.h"
 #include <iostream>
-#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
 #include <cstring>
+#include <cstdlib>
 #include <iomanip>
+#include <algorithm>
+#include <new>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Heap allocations made by this process, for checking that hot paths
+// stay allocation-free
+static size_t allocationCount = 0;
+
+void* operator new(size_t size) {
+    allocationCount++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
 
 void showCPUFeatures() {
     std::cout << "\n💻 CPU FEATURE DETECTION" << std::endl;
     std::cout << "=========================" << std::endl;
     std::cout << "SSE2 support: " << (ASMOptimized::has_sse2() ? "✅ Yes" : "❌ No") << std::endl;
+    std::cout << "SSSE3 support: " << (ASMOptimized::has_ssse3() ? "✅ Yes" : "❌ No") << std::endl;
     std::cout << "AVX support: " << (ASMOptimized::has_avx() ? "✅ Yes" : "❌ No") << std::endl;
     std::cout << "AVX2 support: " << (ASMOptimized::has_avx2() ? "✅ Yes" : "❌ No") << std::endl;
     
-    uint64_t cycles = ASMOptimized::get_cpu_cycles();
-    std::cout << "CPU cycle counter: " << cycles << std::endl;
+    const auto& timing = ASMOptimized::timing_info();
+    std::cout << "Invariant TSC: " << (timing.invariant_tsc ? "✅ Yes" : "❌ No") << std::endl;
+    std::cout << "RDTSCP: " << (timing.has_rdtscp ? "✅ Yes" : "❌ No") << std::endl;
+    std::cout << "Timer source: " << (timing.using_tsc ? "TSC" : "clock_gettime(CLOCK_MONOTONIC)")
+              << " (" << std::fixed << std::setprecision(3) << timing.ticks_per_ns << " ticks/ns)" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
 }
 
 void runMouseParsingBenchmark() {
@@ -26,8 +57,7 @@ void runMouseParsingBenchmark() {
     
     std::cout << "Testing SIMD mouse parsing on " << data_size << " byte buffer" << std::endl;
     
-    auto start_time = std::chrono::high_resolution_clock::now();
-    uint64_t start_cycles = ASMOptimized::get_cpu_cycles();
+    ASMOptimized::Stopwatch timer;
     
     const int iterations = 100000;
     for (int i = 0; i < iterations; i++) {
@@ -37,15 +67,112 @@ void runMouseParsingBenchmark() {
         (void)result.found_escape;
     }
     
-    uint64_t end_cycles = ASMOptimized::get_cpu_cycles();
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    double elapsed_ns = timer.elapsed_ns();
+    
+    std::cout << "Results:" << std::endl;
+    std::cout << "  " << iterations << " parses in " << elapsed_ns / 1000.0 << "μs" << std::endl;
+    std::cout << "  Average parse time: " << elapsed_ns / iterations << "ns" << std::endl;
+}
+
+// Synthetic drag storm: left-button motion reports sweeping the screen
+static std::string buildMotionStream(size_t targetBytes) {
+    std::string stream;
+    stream.reserve(targetBytes + 32);
+    
+    unsigned seed = 12345;
+    int x = 100, y = 50;
+    while (stream.size() < targetBytes) {
+        seed = seed * 1103515245 + 12345;
+        x = std::max(1, std::min(399, x + (int)((seed >> 16) % 5) - 2));
+        y = std::max(1, std::min(119, y + (int)((seed >> 24) % 3) - 1));
+        stream += "\033[<32;" + std::to_string(x) + ";" + std::to_string(y) + "M";
+    }
+    return stream;
+}
+
+// The pre-SIMD decode path (substr + istringstream + stoi), kept for comparison
+static size_t legacyDecodeStream(const std::string& stream, long long& checksum) {
+    size_t events = 0;
+    size_t pos = 0;
+    while ((pos = stream.find("\033[<", pos)) != std::string::npos) {
+        size_t end = stream.find_first_of("Mm", pos);
+        if (end == std::string::npos) break;
+        
+        std::istringstream ss(stream.substr(pos + 3, end - pos - 3));
+        std::string buttonStr, xStr, yStr;
+        if (std::getline(ss, buttonStr, ';') && std::getline(ss, xStr, ';') && std::getline(ss, yStr)) {
+            checksum += std::stoi(buttonStr) + std::stoi(xStr) + std::stoi(yStr);
+            events++;
+        }
+        pos = end + 1;
+    }
+    return events;
+}
+
+void runSGRDecodeBenchmark(const char* capturePath) {
+    std::cout << "\n🖱️  SGR MOUSE DECODE THROUGHPUT" << std::endl;
+    std::cout << "================================" << std::endl;
+    
+    std::string stream;
+    if (capturePath) {
+        std::ifstream in(capturePath, std::ios::binary);
+        std::ostringstream contents;
+        contents << in.rdbuf();
+        stream = contents.str();
+        std::cout << "Recorded stream: " << capturePath << std::endl;
+    }
+    if (stream.empty()) {
+        stream = buildMotionStream(4 * 1024 * 1024);
+        std::cout << "Recorded stream: synthetic drag storm" << std::endl;
+    }
+    double megabytes = stream.size() / (1024.0 * 1024.0);
+    std::cout << "Stream size: " << std::fixed << std::setprecision(2) << megabytes << " MB" << std::endl;
+    
+    // Legacy string-based decoding
+    long long legacyChecksum = 0;
+    ASMOptimized::Stopwatch timer;
+    size_t legacyEvents = legacyDecodeStream(stream, legacyChecksum);
+    double legacyMs = timer.elapsed_ms();
+    
+    // Vectorized decoder over the raw byte stream
+    long long simdChecksum = 0;
+    size_t simdEvents = 0;
+    timer.reset();
+    const char* data = stream.data();
+    size_t pos = 0;
+    while (pos < stream.size()) {
+        ASMOptimized::SGRMouseEvent event;
+        int n = ASMOptimized::fast_decode_sgr_mouse(data + pos, stream.size() - pos, event);
+        if (n <= 0) {
+            pos++;
+            continue;
+        }
+        simdChecksum += event.button + event.x + event.y;
+        simdEvents++;
+        pos += n;
+    }
+    double simdMs = timer.elapsed_ms();
+    
+    // Full input path as used by the event loop
+    FastMouseHandler handler;
+    timer.reset();
+    size_t consumed = handler.feedInput(stream.data(), stream.size());
+    double handlerMs = timer.elapsed_ms();
     
     std::cout << "Results:" << std::endl;
-    std::cout << "  " << iterations << " parses in " << duration.count() << "μs" << std::endl;
-    std::cout << "  Average parse time: " << (duration.count() / (double)iterations) << "μs" << std::endl;
-    std::cout << "  CPU cycles: " << (end_cycles - start_cycles) << std::endl;
-    std::cout << "  Cycles per parse: " << ((end_cycles - start_cycles) / iterations) << std::endl;
+    std::cout << "  Legacy istringstream: " << legacyEvents << " events in " << legacyMs << "ms ("
+              << megabytes / (legacyMs / 1000.0) << " MB/s)" << std::endl;
+    std::cout << (ASMOptimized::has_ssse3() ? "  SSSE3 SGR decoder:    " : "  Scalar SGR decoder:   ") << simdEvents << " events in " << simdMs << "ms ("
+              << megabytes / (simdMs / 1000.0) << " MB/s)" << std::endl;
+    std::cout << "  FastMouseHandler:     " << consumed << " bytes in " << handlerMs << "ms ("
+              << megabytes / (handlerMs / 1000.0) << " MB/s)" << std::endl;
+    std::cout << "  Per event (decoder):  " << simdMs * 1000000.0 / std::max<size_t>(1, simdEvents) << "ns" << std::endl;
+    std::cout << "  Checksums match: " << (legacyChecksum == simdChecksum ? "✅ Yes" : "❌ No") << std::endl;
+    if (simdMs > 0) {
+        std::cout << "  Decoder speedup: " << std::setprecision(1) << legacyMs / simdMs << "x" << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
 }
 
 void runBufferBenchmark() {
@@ -54,8 +181,7 @@ void runBufferBenchmark() {
     
     UnicodeBuffer buffer(80, 24);
     
-    auto start_time = std::chrono::high_resolution_clock::now();
-    uint64_t start_cycles = ASMOptimized::get_cpu_cycles();
+    ASMOptimized::Stopwatch timer;
     
     const int iterations = 1000;
     for (int i = 0; i < iterations; i++) {
@@ -66,16 +192,192 @@ void runBufferBenchmark() {
         // Don't actually render to avoid terminal spam
     }
     
-    uint64_t end_cycles = ASMOptimized::get_cpu_cycles();
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    double elapsed_ns = timer.elapsed_ns();
+    double frame_ns = elapsed_ns / iterations;
+    
+    std::cout << "Results:" << std::endl;
+    std::cout << "  " << iterations << " frames in " << elapsed_ns / 1000000.0 << "ms" << std::endl;
+    std::cout << "  Average frame time: " << frame_ns << "ns" << std::endl;
+    std::cout << "  Estimated FPS: " << (1000000000.0 / frame_ns) << std::endl;
+}
+
+// Swallows presenter output so benchmarks measure encoding, not the terminal
+void runTileDiffBenchmark() {
+    std::cout << "\n🧱 TILE DIFF BENCHMARK (400x120)" << std::endl;
+    std::cout << "=================================" << std::endl;
+    
+    const int width = 400, height = 120;
+    UnicodeBuffer frame(width, height);
+    for (int y = 0; y < height; y++) {
+        frame.drawString(0, y, std::string(width, (char)('a' + y % 26)), y % 2 ? Color::CYAN : Color::YELLOW);
+    }
+    
+    int tileCount = frame.getTileColumns() * frame.getTileRows();
+    const int dirtyCounts[] = { 0, 1, 8, 32, 96, tileCount };
+    const int iterations = 200;
+    
+    int sink = open("/dev/null", O_WRONLY);
+    
+    double results[2][6];
+    for (int skip = 0; skip < 2; skip++) {
+        TerminalOutput output;
+        output.setOutputFd(sink);
+        output.setTileSkipEnabled(skip == 1);
+        output.present(frame);
+        
+        for (int c = 0; c < 6; c++) {
+            ASMOptimized::Stopwatch timer;
+            for (int i = 0; i < iterations; i++) {
+                // One changed cell in each of the first N tiles
+                for (int t = 0; t < dirtyCounts[c]; t++) {
+                    int tx = t % frame.getTileColumns();
+                    int ty = t / frame.getTileColumns();
+                    frame.setCell(tx * UnicodeBuffer::TILE_WIDTH, ty * UnicodeBuffer::TILE_HEIGHT,
+                                  i % 2 ? "#" : "@", Color::RED);
+                }
+                output.present(frame);
+            }
+            results[skip][c] = timer.elapsed_us() / iterations;
+        }
+    }
+    close(sink);
+    
+    std::cout << "Results (" << tileCount << " tiles of " << (int)UnicodeBuffer::TILE_WIDTH << "x"
+              << (int)UnicodeBuffer::TILE_HEIGHT << ", per present):" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (int c = 0; c < 6; c++) {
+        std::cout << "  " << std::setw(3) << dirtyCounts[c] << " dirty tiles: "
+                  << std::setw(8) << results[1][c] << "μs with tile skipping, "
+                  << std::setw(8) << results[0][c] << "μs full compare" << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+void runHitTestBenchmark() {
+    std::cout << "\n🎯 HIT TEST BENCHMARK (dashboard, 240x80)" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    
+    // A dashboard: a grid of small buttons with a few overlapping panels
+    const int width = 240, height = 80;
+    std::vector<Rect> rects;
+    for (int y = 0; y + 3 <= height; y += 4) {
+        for (int x = 0; x + 8 <= width; x += 8) {
+            rects.push_back(Rect(x, y, 7, 3));
+        }
+    }
+    for (int i = 0; i < 20; i++) {
+        rects.push_back(Rect((i * 37) % (width - 40), (i * 11) % (height - 20), 40, 20));
+    }
+    
+    HitIndex index;
+    index.resize(width, height);
+    for (size_t i = 0; i < rects.size(); i++) {
+        index.set((uint32_t)i + 1, rects[i], (uint32_t)i);
+    }
+    
+    const int queries = 200000;
+    long long checksum = 0;
+    
+    // Linear: topmost is the last rect containing the point
+    ASMOptimized::Stopwatch timer;
+    for (int q = 0; q < queries; q++) {
+        int x = (int)((q * 7919LL) % width), y = (int)((q * 104729LL) % height);
+        for (int i = (int)rects.size() - 1; i >= 0; i--) {
+            if (rects[i].contains(x, y)) {
+                checksum += i + 1;
+                break;
+            }
+        }
+    }
+    double linearTime = timer.elapsed_us();
+    long long linearSum = checksum;
+    
+    timer.reset();
+    for (int q = 0; q < queries; q++) {
+        int x = (int)((q * 7919LL) % width), y = (int)((q * 104729LL) % height);
+        checksum -= index.query(x, y);
+    }
+    double indexTime = timer.elapsed_us();
+    
+    std::cout << "Results (" << rects.size() << " targets):" << std::endl;
+    std::cout << "  Linear scan: " << linearTime * 1000 / queries << "ns per query" << std::endl;
+    std::cout << "  Grid index:  " << indexTime * 1000 / queries << "ns per query" << std::endl;
+    std::cout << "  Speedup: " << linearTime / indexTime << "x" << (checksum == 0 ? "" : " (MISMATCH)") << std::endl;
+    
+    if (!UnicodeBuffer::hasPickBuffer()) {
+        std::cout << "  Pick buffer: not built (ENABLE_PICK_BUFFER / make PICK_BUFFER=1)" << std::endl;
+        return;
+    }
+    
+    // Pick buffer: composite every target bottom to top, then each query is
+    // one load. The composite is paid per frame, not per query.
+    UnicodeBuffer screen(width, height);
+    const int frames = 200;
+    timer.reset();
+    for (int f = 0; f < frames; f++) {
+        screen.setOwner(0);
+        screen.fillRect(0, 0, width, height, " ", Color::RESET);
+        for (size_t i = 0; i < rects.size(); i++) {
+            screen.setOwner((uint32_t)i + 1);
+            screen.fillRect(rects[i].x, rects[i].y, rects[i].w, rects[i].h, " ", Color::WHITE);
+        }
+    }
+    double compositeTime = timer.elapsed_us();
+    
+    long long pickSum = 0;
+    timer.reset();
+    for (int q = 0; q < queries; q++) {
+        int x = (int)((q * 7919LL) % width), y = (int)((q * 104729LL) % height);
+        pickSum += screen.ownerAt(x, y);
+    }
+    double pickTime = timer.elapsed_us();
+    
+    std::cout << "  Pick buffer: " << pickTime * 1000 / queries << "ns per query, "
+              << compositeTime / frames << "μs per composite" << std::endl;
+    std::cout << "  Speedup: " << linearTime / pickTime << "x" << (pickSum == linearSum ? "" : " (MISMATCH)") << std::endl;
+}
+
+void runEventDispatchBenchmark() {
+    std::cout << "\n📨 EVENT DISPATCH BENCHMARK (500 listeners)" << std::endl;
+    std::cout << "==========================================" << std::endl;
+    
+    EventManager& events = EventManager::getInstance();
+    const int listenerCount = 500;
+    const int iterations = 2000;
+    
+    // Each listener captures a widget pointer and a counter, as a widget
+    // subscribing `this` would
+    std::vector<int> hits(listenerCount, 0);
+    std::vector<EventManager::ListenerId> ids;
+    for (int i = 0; i < listenerCount; i++) {
+        int* counter = &hits[i];
+        ids.push_back(events.subscribe(EventType::MOUSE_MOVE, [counter, i](const Event& event) {
+            const MouseEvent& mouse = static_cast<const MouseEvent&>(event);
+            if (mouse.x >= i % 80) (*counter)++;
+        }));
+    }
+    
+    // Warm the queue up to its working size
+    events.post(MouseEvent(EventType::MOUSE_MOVE, 0, 0));
+    events.processQueue();
+    
+    size_t allocationsBefore = allocationCount;
+    ASMOptimized::Stopwatch timer;
+    for (int i = 0; i < iterations; i++) {
+        events.post(MouseEvent(EventType::MOUSE_MOVE, i % 120, i % 40));
+        events.processQueue();
+    }
+    double perEvent = timer.elapsed_us() / iterations;
+    size_t allocations = allocationCount - allocationsBefore;
+    
+    for (EventManager::ListenerId id : ids) {
+        events.unsubscribe(id);
+    }
     
     std::cout << "Results:" << std::endl;
-    std::cout << "  " << iterations << " frames in " << duration.count() << "ms" << std::endl;
-    std::cout << "  Average frame time: " << (duration.count() / (double)iterations) << "ms" << std::endl;
-    std::cout << "  Estimated FPS: " << (1000.0 / (duration.count() / (double)iterations)) << std::endl;
-    std::cout << "  CPU cycles: " << (end_cycles - start_cycles) << std::endl;
-    std::cout << "  Cycles per frame: " << ((end_cycles - start_cycles) / iterations) << std::endl;
+    std::cout << "  Mouse move to " << listenerCount << " listeners: " << perEvent << "μs per event" << std::endl;
+    std::cout << "  Heap allocations during " << iterations << " dispatches: " << allocations << std::endl;
 }
 
 void runSIMDMemoryBenchmark() {
@@ -86,40 +388,42 @@ void runSIMDMemoryBenchmark() {
     char* buffer = new char[buffer_size];
     
     // Test standard memset
-    auto start_time = std::chrono::high_resolution_clock::now();
+    ASMOptimized::Stopwatch timer;
     for (int i = 0; i < 100; i++) {
         memset(buffer, ' ', buffer_size);
     }
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto standard_duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    double standard_us = timer.elapsed_us();
     
-    // Test SIMD memset (placeholder - same as standard for now)
-    start_time = std::chrono::high_resolution_clock::now();
+    // Test SIMD memset
+    timer.reset();
     for (int i = 0; i < 100; i++) {
-        memset(buffer, ' ', buffer_size); // Would be SIMD optimized version
+        ASMOptimized::fast_memset_pattern(buffer, ' ', buffer_size);
     }
-    end_time = std::chrono::high_resolution_clock::now();
-    auto simd_duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    double simd_us = timer.elapsed_us();
     
     std::cout << "Results (100 x 1MB fills):" << std::endl;
-    std::cout << "  Standard memset: " << standard_duration.count() << "μs" << std::endl;
-    std::cout << "  SIMD memset: " << simd_duration.count() << "μs" << std::endl;
+    std::cout << "  Standard memset: " << standard_us << "μs" << std::endl;
+    std::cout << "  SIMD memset: " << simd_us << "μs" << std::endl;
     
-    if (simd_duration.count() > 0) {
-        double speedup = (double)standard_duration.count() / simd_duration.count();
+    if (simd_us > 0) {
+        double speedup = standard_us / simd_us;
         std::cout << "  SIMD speedup: " << std::fixed << std::setprecision(2) << speedup << "x" << std::endl;
     }
     
     delete[] buffer;
 }
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "🚀 TUI FRAMEWORK ASM OPTIMIZATION BENCHMARK" << std::endl;
     std::cout << "============================================" << std::endl;
     
     showCPUFeatures();
     runMouseParsingBenchmark();
+    runSGRDecodeBenchmark(argc > 1 ? argv[1] : nullptr);
     runBufferBenchmark();
+    runTileDiffBenchmark();
+    runHitTestBenchmark();
+    runEventDispatchBenchmark();
     runSIMDMemoryBenchmark();
     
     std::cout << "\n📊 KEY ASM OPTIMIZATION OPPORTUNITIES:" << std::endl;
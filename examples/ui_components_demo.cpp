@@ -45,17 +45,17 @@ public:
         // Main window for basic components
         mainWindow = std::make_shared<Window>(5, 2, 45, 20, "UI Components Demo");
         mainWindow->visible = true;
-        windows.push_back(mainWindow);
+        addWindow(mainWindow);
         
         // Form window for input components  
         formWindow = std::make_shared<Window>(55, 2, 35, 15, "Form Controls");
         formWindow->visible = true;
-        windows.push_back(formWindow);
+        addWindow(formWindow);
         
         // List window
         listWindow = std::make_shared<Window>(5, 25, 85, 12, "List & Status Demo");
         listWindow->visible = true;
-        windows.push_back(listWindow);
+        addWindow(listWindow);
     }
     
     void setupComponents() {
@@ -250,34 +250,22 @@ public:
             
             // Update terminal size
             updateTerminalSize();
+            windows.setScreen(term_width, term_height);
             if (buffer) {
                 delete buffer;
                 buffer = new UnicodeBuffer(term_width, term_height);
             }
             
             buffer->clear();
-            drawBackground();
+            fillBackground();
             
-            // Update windows
-            for (auto& window : windows) {
-                window->active = false;
-            }
+            // Mouse handling for the visible windows, top first
+            updateWindows();
             
-            // Update windows for mouse interaction
-            for (int i = windows.size() - 1; i >= 0; i--) {
-                if (windows[i]->isVisible()) {
-                    windows[i]->updateMouse(mouse, term_width, term_height);
-                    if (windows[i]->dragging || windows[i]->resizing) {
-                        windows[i]->active = true;
-                        if (i != windows.size() - 1) {
-                            auto temp = windows[i];
-                            windows.erase(windows.begin() + i);
-                            windows.push_back(temp);
-                        }
-                        break;
-                    }
-                }
-            }
+            // Hover, clicks and focus for the widgets that take them
+            updateHitTargets();
+            pointer.update(mouse.getMouseX(), mouse.getMouseY(), mouse.isLeftButtonPressed());
+            pointer.wheel(mouse.getWheelDeltaX(), mouse.getWheelDeltaY());
             
             // Clear window content before adding instructions
             mainWindow->content.clear();
@@ -290,13 +278,14 @@ public:
             drawInstructions();
             
             // Draw windows and their components in z-order to prevent overlap issues
-            for (auto& window : windows) {
+            for (WindowManager::Handle h = windows.bottomLive(); h; h = windows.liveAbove(h)) {
+                Window* window = windows.get(h);
                 if (window->isVisible()) {
                     // Draw the window first
                     window->draw(*buffer);
                     
                     // Then immediately draw all components belonging to this window
-                    if (window == mainWindow) {
+                    if (window == mainWindow.get()) {
                         // Draw mainWindow components
                         if (progressBar) {
                             progressBar->updateMouse(mouse, term_width, term_height);
@@ -309,12 +298,10 @@ public:
                         }
                         
                         if (checkbox1) {
-                            checkbox1->updateMouse(mouse, term_width, term_height);
                             checkbox1->draw(*buffer);
                         }
                         
                         if (checkbox2) {
-                            checkbox2->updateMouse(mouse, term_width, term_height);
                             checkbox2->draw(*buffer);
                         }
                         
@@ -323,27 +310,23 @@ public:
                             radioButtons->draw(*buffer);
                         }
                     }
-                    else if (window == formWindow) {
+                    else if (window == formWindow.get()) {
                         // Draw formWindow components
                         if (textInput) {
-                            textInput->updateMouse(mouse, term_width, term_height);
                             textInput->draw(*buffer);
                         }
                         
                         if (passwordInput) {
-                            passwordInput->updateMouse(mouse, term_width, term_height);
                             passwordInput->draw(*buffer);
                         }
                     }
-                    else if (window == listWindow) {
+                    else if (window == listWindow.get()) {
                         // Draw listWindow components
                         if (listBox) {
-                            listBox->updateMouse(mouse, term_width, term_height);
                             listBox->draw(*buffer);
                         }
                         
                         if (statusBar) {
-                            statusBar->updateMouse(mouse, term_width, term_height);
                             statusBar->draw(*buffer);
                         }
                     }
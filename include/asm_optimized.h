@@ -30,35 +30,114 @@ namespace ASMOptimized {
     // Vectorized mouse input parsing
     MouseParseResult fast_parse_mouse_input(const char* buffer, size_t length);
     
-    // Box drawing optimizations
-    void fast_draw_horizontal_line(char** cells, char** colors, 
-                                  int x, int y, int width, 
-                                  const char* character, const char* color);
+    // Decoded SGR (1006) mouse report: "\033[<b;x;yM" or "\033[<b;x;ym"
+    struct SGRMouseEvent {
+        int button;              // Raw button code including modifier/motion bits
+        int x, y;                // 1-based terminal coordinates as reported
+        bool press;              // 'M' = press/motion, 'm' = release
+    };
+    
+    // Validates and decodes one SGR report starting at buffer[0]. On CPUs
+    // with SSSE3 (checked at run time) this is a single vector pass (digit
+    // masks + shuffle + multiply-add reduction), otherwise a scalar loop
+    // giving the same results.
+    // Returns bytes consumed, 0 if the report is incomplete, -1 if malformed.
+    int fast_decode_sgr_mouse(const char* buffer, size_t length, SGRMouseEvent& event);
+    
+    // Box drawing optimizations on UnicodeBuffer cell planes.
+    // Pointers address the first cell; callers clip before calling.
+    void fast_draw_horizontal_line(uint32_t* glyphs, uint16_t* styles, size_t length,
+                                   uint32_t glyph, uint16_t style);
+    
+    void fast_draw_vertical_line(uint32_t* glyphs, uint16_t* styles, size_t stride,
+                                 size_t length, uint32_t glyph, uint16_t style);
+    
+    // Memory operations on UnicodeBuffer cell storage (glyph plane + style plane)
+    // Rows are `stride` cells apart; plane starts are expected to be 32-byte aligned.
+    void fast_buffer_clear_optimized(uint32_t* glyphs, uint16_t* styles, size_t count,
+                                     uint32_t glyph, uint16_t style);
+    void fast_rect_fill(uint32_t* glyphs, uint16_t* styles, size_t stride,
+                        size_t w, size_t h, uint32_t glyph, uint16_t style);
+    bool fast_string_equal(const char* a, size_t a_len, const char* b, size_t b_len);
+    
+    // Copies a w x h block of cells between planes. Source style ids are
+    // translated through style_map; pass nullptr when both share one table.
+    void fast_blit_cells(uint32_t* dst_glyphs, uint16_t* dst_styles, size_t dst_stride,
+                         const uint32_t* src_glyphs, const uint16_t* src_styles, size_t src_stride,
+                         size_t w, size_t h, const uint16_t* style_map);
+    
+    // Style-run detection over a row of StyleIds (AVX2: 16 cells per compare)
+    size_t fast_style_run_length(const uint16_t* styles, size_t count);
+    
+    // Cell comparison between two frames' planes (AVX2: 8 cells per step).
+    // Return the index of the first differing / first matching cell, or count.
+    size_t fast_cells_find_diff(const uint32_t* glyphs_a, const uint16_t* styles_a,
+                                const uint32_t* glyphs_b, const uint16_t* styles_b, size_t count);
+    size_t fast_cells_find_equal(const uint32_t* glyphs_a, const uint16_t* styles_a,
+                                 const uint32_t* glyphs_b, const uint16_t* styles_b, size_t count);
     
-    void fast_draw_vertical_line(char** cells, char** colors,
-                                int x, int y, int height,
-                                const char* character, const char* color);
+    // 64-bit hash of a w x h block of cells (AVX2: 8 cells per step, same
+    // result as the scalar path)
+    uint64_t fast_hash_cells(const uint32_t* glyphs, const uint16_t* styles, size_t stride,
+                             size_t w, size_t h);
     
-    // Memory operations
-    void fast_clear_buffer(char** cells, char** colors, 
-                          size_t width, size_t height);
+    // Copies a run of packed glyphs out as UTF-8, packing 8 ASCII glyphs per
+    // vector. `out` needs room for 4 bytes per glyph. Returns bytes written.
+    size_t fast_encode_glyph_run(const uint32_t* glyphs, size_t count, char* out);
+    
+    // 32-byte aligned allocation for SIMD-friendly planes
+    void* aligned_alloc_simd(size_t bytes);
+    void aligned_free_simd(void* ptr);
     
     // CPU feature detection
     bool has_sse2();
     bool has_avx();
     bool has_avx2();
+    bool has_ssse3();
     
     // Performance measurement
     uint64_t get_cpu_cycles();
     
+    // Calibrated timing. "Ticks" are TSC ticks when the TSC is invariant,
+    // otherwise CLOCK_MONOTONIC nanoseconds (ticks_per_ns == 1).
+    struct TimingInfo {
+        bool invariant_tsc;      // CPUID 0x80000007 EDX[8]
+        bool has_rdtscp;         // CPUID 0x80000001 EDX[27]
+        bool using_tsc;          // false = clock_gettime fallback
+        double ticks_per_ns;     // Calibrated against CLOCK_MONOTONIC
+    };
+    
+    const TimingInfo& timing_info();   // Calibrates once on first use (~10ms)
+    uint64_t read_ticks_begin();       // lfence; rdtsc - not hoisted above earlier work
+    uint64_t read_ticks_end();         // rdtscp; lfence - waits for earlier work to retire
+    double ticks_to_ns(uint64_t ticks);
+    uint64_t monotonic_ns();           // Plain CLOCK_MONOTONIC
+    
+    // Fenced interval timer reporting nanoseconds
+    class Stopwatch {
+    public:
+        Stopwatch() : start_ticks(read_ticks_begin()) {}
+        void reset() { start_ticks = read_ticks_begin(); }
+        double elapsed_ns() const { return ticks_to_ns(read_ticks_end() - start_ticks); }
+        double elapsed_us() const { return elapsed_ns() / 1000.0; }
+        double elapsed_ms() const { return elapsed_ns() / 1000000.0; }
+        
+    private:
+        uint64_t start_ticks;
+    };
+    
     // Advanced SIMD operations
     void fast_memset_pattern(void* dest, int pattern, size_t count);
     size_t fast_string_compare_colors(const char* color1, const char* color2, size_t max_len);
     
-    // Optimized box drawing
-    void fast_draw_box_borders(char** cells, char** colors, int x, int y, int w, int h,
-                              char corner_char, char horizontal_char, char vertical_char,
-                              const char* color);
+    // Optimized box drawing (w, h >= 2, box fully inside the planes)
+    struct BoxGlyphs {
+        uint32_t top_left, top_right, bottom_left, bottom_right;
+        uint32_t horizontal, vertical;
+    };
+    
+    void fast_draw_box_borders(uint32_t* glyphs, uint16_t* styles, size_t stride,
+                               size_t w, size_t h, const BoxGlyphs& box, uint16_t style);
     
     // Cache optimization
     void prefetch_buffer_region(void* buffer, size_t size);
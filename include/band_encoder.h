@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstddef>
+
+struct iovec;
+
+// Encodes a frame as horizontal bands of rows on the shared WorkerPool.
+// Each band writes into its own reused arena, so bands never contend for
+// output space; the arenas are then written in order with one writev().
+// Encoders must make each band's bytes independent of the bands before it,
+// e.g. by starting from a known cursor position and SGR state.
+class BandEncoder {
+public:
+    // Writes rows [y0, y1) at `out` and returns the end of what it wrote
+    typedef std::function<char*(int y0, int y1, char* out)> EncodeFunction;
+    
+    BandEncoder() : bandCount(0) {}
+    
+    // Splits `rows` into bands whose heights are multiples of `rowAlign`
+    // and encodes them. `maxRowBytes` bounds what one row can produce.
+    // Jobs touching fewer than `minParallelCells` cells in total are
+    // encoded as a single band on the calling thread.
+    void encode(int rows, int rowAlign, size_t maxRowBytes, size_t workCells,
+                const EncodeFunction& encodeBand);
+    
+    size_t getBandCount() const { return bandCount; }
+    size_t size() const;
+    
+    // Writes `head`, the bands and `tail` to fd, retrying short writes.
+    // Returns false on a write error.
+    bool writeTo(int fd, const std::string& head, const std::string& tail) const;
+    // The same for a non-blocking fd, without waiting: whatever the fd
+    // does not take right away is appended to `rest`
+    bool writeAvailable(int fd, const std::string& head, const std::string& tail, std::string& rest) const;
+    // Appends the bands to a string instead
+    void appendTo(std::string& out) const;
+    
+    // Jobs smaller than this are not worth waking the pool for
+    static size_t minParallelCells;
+
+private:
+    struct Band {
+        std::string arena;
+        int y0, y1;
+        size_t length;
+    };
+    std::vector<Band> bands;
+    size_t bandCount;
+    
+    void collectChunks(std::vector<iovec>& chunks, const std::string& head, const std::string& tail) const;
+};
@@ -1,8 +1,13 @@
 #pragma once
 
 #include "colors.h"
+#include "region.h"
+#include "band_encoder.h"
 #include <vector>
 #include <string>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
 
 // Unicode string utilities
 class UnicodeUtils {
@@ -10,22 +15,215 @@ public:
     static int getDisplayWidth(const std::string& text);
     static std::vector<std::string> splitIntoChars(const std::string& text);
     static std::string substring(const std::string& text, int start, int length);
+
+    // Packed glyph helpers: one UTF-8 character stored little-endian in a uint32_t
+    static uint32_t encodeGlyph(const char* text, size_t length);
+    static uint32_t encodeGlyph(const std::string& ch) { return encodeGlyph(ch.data(), ch.size()); }
+    static int glyphByteLength(uint32_t glyph);
+    static size_t nextCharLength(const char* text, size_t remaining);
+};
+
+// Build with TUI_PICK_BUFFER=1 to record which owner drew each cell
+#ifndef TUI_PICK_BUFFER
+#define TUI_PICK_BUFFER 0
+#endif
+
+// Index into a UnicodeBuffer's style table (0 is always Color::RESET)
+typedef uint16_t StyleId;
+
+struct AlignedPlaneDeleter {
+    void operator()(void* ptr) const;
 };
 
+// Where a drawing primitive lands: the cell planes, their stride, the clip
+// rect in plane coordinates and the translation applied to incoming
+// coordinates. Touched tiles get `stamp` written into tileVersions, and
+// with a pick plane every written cell gets `owner`.
+struct CellTarget {
+    uint32_t* glyphs;
+    StyleId* styles;
+    uint32_t* owners;            // Null unless built with TUI_PICK_BUFFER
+    uint32_t owner;
+    int stride;
+    Rect clip;
+    int dx, dy;
+    uint64_t* tileVersions;
+    int tileColumns;
+    uint64_t stamp;
+};
+
+class BufferView;
+class DisplayList;
+
 class UnicodeBuffer {
 private:
     int width, height;
-    std::vector<std::vector<std::string>> cells;
-    std::vector<std::vector<std::string>> colors;
+    int stride;                  // Cells per row, padded so every row starts 32-byte aligned
+
+    // Cell storage as two parallel planes so fills and compares vectorize
+    std::unique_ptr<uint32_t, AlignedPlaneDeleter> glyphs;
+    std::unique_ptr<StyleId, AlignedPlaneDeleter> styles;
+    // Pick plane: id of whatever drew each cell (TUI_PICK_BUFFER builds only)
+    std::unique_ptr<uint32_t, AlignedPlaneDeleter> owners;
+    uint32_t currentOwner;
+
+    // Style interning
+    std::vector<std::string> styleTable;
+    std::unordered_map<std::string, StyleId> styleLookup;
+    StyleId lastStyleId;
+    size_t maxStyleLength;
+
+    BandEncoder frameBands;      // Reused per-band encode buffers for render()
     
+    // Clip rect (buffer coordinates) and translation applied to every
+    // primitive. The bottom entry is the whole buffer with no offset.
+    struct ClipState {
+        Rect clip;
+        int dx, dy;
+    };
+    std::vector<ClipState> clipStack;
+    
+    // Cached translation of this buffer's style ids into another buffer's
+    // table, rebuilt when blitted into a different target
+    uint32_t instanceId;
+    mutable std::vector<StyleId> exportMap;
+    mutable uint32_t exportTarget;
+    
+    // Display list receiving drawing calls instead of the planes, and the
+    // clip stack depth to return to when recording ends
+    DisplayList* recorder;
+    size_t recordBase;
+    
+    // Modification stamp of each tile. Every drawing call takes a new stamp
+    // from modCount, so a presenter that remembers modCount can tell which
+    // tiles were drawn to since it last looked.
+    int tileColumns, tileRows;
+    std::vector<uint64_t> tileVersions;
+    uint64_t modCount;
+
+    const ClipState& current() const { return clipStack.back(); }
+    CellTarget target();
+
 public:
+    // Tile size used for change tracking and per-tile diffing
+    enum { TILE_WIDTH = 32, TILE_HEIGHT = 8 };
+    
     UnicodeBuffer(int w, int h);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getStride() const { return stride; }
+    uint32_t getInstanceId() const { return instanceId; }
+    
+    // Read access to the cell planes for presenters and diffing
+    const uint32_t* glyphRow(int y) const { return glyphs.get() + (size_t)y * stride; }
+    const StyleId* styleRow(int y) const { return styles.get() + (size_t)y * stride; }
+    // Upper bound on the bytes encodeSpan() writes per cell
+    size_t maxEncodedCellBytes() const { return 4 + maxStyleLength; }
+
+    // Tile change tracking. A tile whose version is above a modCount read
+    // earlier has been drawn to since; it may still hold the same cells.
+    int getTileColumns() const { return tileColumns; }
+    int getTileRows() const { return tileRows; }
+    uint64_t getModCount() const { return modCount; }
+    uint64_t getTileVersion(int tx, int ty) const { return tileVersions[(size_t)ty * tileColumns + tx]; }
+    // Cells covered by a tile, clipped to the buffer
+    Rect tileRect(int tx, int ty) const;
+    // Hash of a tile's glyphs and style ids
+    uint64_t tileHash(int tx, int ty) const;
+
+    // Pick buffer. In TUI_PICK_BUFFER builds every drawing call also stores
+    // the current owner id in the cells it writes, and blit() carries the
+    // source's owners across (cells it never drew take this buffer's
+    // owner), so ownerAt() names whatever is visible at a cell. Otherwise
+    // ownerAt() is always 0. Ids come from allocateOwnerId(); 0 is nobody.
+    static bool hasPickBuffer();
+    static uint32_t allocateOwnerId();
+    void setOwner(uint32_t id) { currentOwner = id; }
+    uint32_t getOwner() const { return currentOwner; }
+    uint32_t ownerAt(int x, int y) const;
+
+    StyleId internStyle(const std::string& color);
+    const std::string& styleString(StyleId id) const { return styleTable[id]; }
+
+    // Clip and translation stack. pushClip takes a rect in the current
+    // coordinates; pushTranslation shifts the origin; pushViewport does both
+    // so a widget can draw in local coordinates clipped to its area.
+    // Every push is undone by one pop().
+    void pushClip(const Rect& rect);
+    void pushTranslation(int dx, int dy);
+    void pushViewport(const Rect& rect);
+    void pop();
+    // Current clip rect in the current coordinates
+    Rect getClip() const;
+    
+    // View of `area` (current coordinates) with its origin at the area's
+    // top-left, clipped to the area and the current clip
+    BufferView view(const Rect& area);
     
     void clear();
     void setCell(int x, int y, const std::string& ch, const std::string& color);
     void drawString(int x, int y, const std::string& text, const std::string& color);
     void drawStringClipped(int x, int y, const std::string& text, const std::string& color, int maxX);
+    void drawHLine(int x, int y, int length, const std::string& ch, const std::string& color);
+    void drawVLine(int x, int y, int length, const std::string& ch, const std::string& color);
     void drawBox(int x, int y, int w, int h, const std::string& color, bool rounded = false, bool heavy = false);
     void fillRect(int x, int y, int w, int h, const std::string& character, const std::string& color);
     void render();
-};
\ No newline at end of file
+    // Encode cells [x0, x1) of row y as SGR + UTF-8, one SGR per style run.
+    // `currentStyle` is the style the terminal is in (-1 if unknown).
+    char* encodeSpan(char* out, int y, int x0, int x1, int& currentStyle) const;
+    
+    // Composite a w x h block of another buffer's cells at (dstX, dstY)
+    void blit(const UnicodeBuffer& src, int srcX, int srcY, int w, int h, int dstX, int dstY);
+    
+    // Make this buffer a copy of `src`, which must be the same size: cells,
+    // style table, tile versions and identity, so a presenter treats the
+    // copy as `src` at this moment. Copying again from the same buffer only
+    // copies the tiles drawn to since the last time.
+    void snapshotFrom(const UnicodeBuffer& src);
+    
+    // Retained drawing. Between beginRecording() and endRecording() the
+    // drawing calls (views included) are appended to `list` instead of
+    // touching the cells; the origin moves to the current one and clipping
+    // only applies from clips pushed while recording. replay() draws a list
+    // under the current clip and translation. clear() and blit() are not
+    // recorded.
+    void beginRecording(DisplayList& list);
+    void endRecording();
+    DisplayList* getRecorder() const { return recorder; }
+    void replay(const DisplayList& list);
+};
+
+// Lightweight handle onto part of a UnicodeBuffer's cell storage: plane
+// pointers, stride, clip and origin. Views are plain values, so a window
+// can hand one to each child without allocating. Styles are interned in
+// the owning buffer.
+class BufferView {
+private:
+    UnicodeBuffer* owner;
+    CellTarget target;
+    int width, height;           // Local extent, before clipping
+
+public:
+    BufferView(UnicodeBuffer& buffer, const CellTarget& target, int w, int h)
+        : owner(&buffer), target(target), width(w), height(h) {}
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    // Visible part of the view in local coordinates
+    Rect getClip() const;
+
+    // Child view of `area` (local coordinates), origin at its top-left
+    BufferView subView(const Rect& area) const;
+    // Same origin, clip narrowed to `area` (local coordinates)
+    BufferView clipped(const Rect& area) const;
+
+    void setCell(int x, int y, const std::string& ch, const std::string& color);
+    void drawString(int x, int y, const std::string& text, const std::string& color);
+    void drawStringClipped(int x, int y, const std::string& text, const std::string& color, int maxX);
+    void drawHLine(int x, int y, int length, const std::string& ch, const std::string& color);
+    void drawVLine(int x, int y, int length, const std::string& ch, const std::string& color);
+    void drawBox(int x, int y, int w, int h, const std::string& color, bool rounded = false, bool heavy = false);
+    void fillRect(int x, int y, int w, int h, const std::string& character, const std::string& color);
+};
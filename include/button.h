@@ -0,0 +1,144 @@
+#pragma once
+
+#include "buffer.h"
+#include "mouse_handler.h"
+#include "colors.h"
+#include "event_system.h"
+#include <string>
+#include <functional>
+#include <memory>
+
+// Forward declaration
+class Window;
+
+enum class ButtonType {
+    REGULAR,
+    TOGGLE,
+    DISABLED
+};
+
+enum class ButtonState {
+    NORMAL,
+    HOVERED,
+    PRESSED,
+    TOGGLED_ON,
+    TOGGLED_OFF
+};
+
+// Button events
+class ButtonEvent : public Event {
+public:
+    std::weak_ptr<class Button> button;
+    std::string buttonText;
+    int buttonX, buttonY;        // Position relative to the parent's content area
+    bool toggleState;            // BUTTON_TOGGLE: state after the toggle
+
+    ButtonEvent(EventType type, std::shared_ptr<class Button> button);
+};
+
+// Push button drawn inside a window's content area, with a drop shadow
+// that disappears while it is held down
+class Button {
+private:
+    int x, y;                    // Position relative to the parent's content area
+    int w, h;
+    std::string text;
+    ButtonType type;
+    ButtonState state;
+    bool enabled;
+    bool toggled;
+    std::weak_ptr<Window> parentWindow;
+    bool showShadow;
+
+    // Mouse state from the previous update
+    bool wasLeftPressed;
+    bool isHovered;
+    bool wasHovered;
+
+    // Visual properties
+    std::string textColor;
+    std::string backgroundColor;
+    std::string hoverColor;
+    std::string pressedColor;
+    std::string toggledColor;
+    std::string disabledColor;
+    std::string shadowColor;
+
+    // Plain callbacks, besides the events below
+    std::function<void()> onClick;
+    std::function<void(bool)> onToggle;
+
+    void updateState(bool mouseOver, bool mousePressed);
+    void drawShadow(UnicodeBuffer& buffer);
+    void drawBackground(UnicodeBuffer& buffer);
+    void drawText(UnicodeBuffer& buffer);
+    std::string getDisplayText() const;
+    std::string getCurrentBackgroundColor() const;
+    std::string getCurrentTextColor() const;
+    void generateButtonEvent(EventType type);
+    void generateMouseEvents(const FastMouseHandler& mouse);
+
+public:
+    Button(int x, int y, int w, int h, const std::string& text,
+           std::shared_ptr<Window> parent = nullptr, ButtonType type = ButtonType::REGULAR);
+    ~Button() = default;
+
+    void draw(UnicodeBuffer& buffer);
+    void updateMouse(FastMouseHandler& mouse);
+
+    // Screen position of the top-left cell
+    int getAbsoluteX() const;
+    int getAbsoluteY() const;
+    // Screen coordinates
+    bool contains(int mx, int my) const;
+    // Coordinates relative to the parent's content area
+    bool containsRelative(int mx, int my) const;
+
+    // State management
+    bool isPressed() const;
+    bool isToggleButton() const;
+    bool isToggled() const { return toggled; }
+    bool isEnabled() const { return enabled; }
+    ButtonState getState() const { return state; }
+    std::string getStateDescription() const;
+    void setEnabled(bool enabled);
+    void setToggled(bool toggled);
+
+    // Content and geometry
+    void setText(const std::string& newText);
+    std::string getText() const { return text; }
+    void setPosition(int newX, int newY);
+    void setSize(int newW, int newH);
+    int getX() const { return x; }
+    int getY() const { return y; }
+    int getWidth() const { return w; }
+    int getHeight() const { return h; }
+
+    void setOnClick(std::function<void()> callback);
+    void setOnToggle(std::function<void(bool)> callback);
+
+    void setParentWindow(std::shared_ptr<Window> parent);
+    std::shared_ptr<Window> getParentWindow() const;
+
+    // Visual configuration; empty `disabled` or `toggledOn` keeps the current color
+    void setColors(const std::string& text, const std::string& background,
+                   const std::string& hover, const std::string& pressed,
+                   const std::string& disabled = "", const std::string& toggledOn = "");
+    void setShadow(const std::string& shadowColor, bool enable = true);
+
+    // Event callbacks
+    Delegate<void(const ButtonEvent&)> onButtonClick;
+    Delegate<void(const ButtonEvent&)> onButtonPress;
+    Delegate<void(const ButtonEvent&)> onButtonRelease;
+    Delegate<void(const ButtonEvent&)> onButtonToggle;
+    Delegate<void(const MouseEvent&)> onButtonHover;
+    Delegate<void(const MouseEvent&)> onButtonLeave;
+
+    // Event callback setters
+    void setOnButtonClick(Delegate<void(const ButtonEvent&)> callback) { onButtonClick = std::move(callback); }
+    void setOnButtonPress(Delegate<void(const ButtonEvent&)> callback) { onButtonPress = std::move(callback); }
+    void setOnButtonRelease(Delegate<void(const ButtonEvent&)> callback) { onButtonRelease = std::move(callback); }
+    void setOnButtonToggle(Delegate<void(const ButtonEvent&)> callback) { onButtonToggle = std::move(callback); }
+    void setOnButtonHover(Delegate<void(const MouseEvent&)> callback) { onButtonHover = std::move(callback); }
+    void setOnButtonLeave(Delegate<void(const MouseEvent&)> callback) { onButtonLeave = std::move(callback); }
+};
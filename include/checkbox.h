@@ -4,6 +4,7 @@
 #include "mouse_handler.h"
 #include "colors.h"
 #include "event_system.h"
+#include "pointer_tracker.h"
 #include <string>
 #include <functional>
 #include <memory>
@@ -42,11 +43,13 @@ private:
     std::string activeColor;
     std::string disabledColor;
     
-    // Mouse interaction
-    bool wasLeftPressed;
+    // Hover and clicks arrive from the PointerTracker
+    PointerTarget pointer;
     
     void generateCheckboxEvent(EventType type, bool oldState, bool newState);
     void calculateDimensions();
+    void handlePointer(const MouseEvent& event);
+    void placePointerTarget();
     
 public:
     Checkbox(std::shared_ptr<Window> parent, int x, int y, const std::string& label, bool initialState = false);
@@ -69,35 +72,34 @@ public:
     void setColors(const std::string& box, const std::string& labelCol, const std::string& active = "", const std::string& disabled = "");
     
     // Interaction
-    void updateMouse(FastMouseHandler& mouse, int termWidth, int termHeight);
     bool contains(int mx, int my) const;
     
     // Rendering
     void draw(UnicodeBuffer& buffer);
-    void show() { visible = true; }
-    void hide() { visible = false; }
+    void show() { visible = true; placePointerTarget(); }
+    void hide() { visible = false; placePointerTarget(); }
     bool isVisible() const { return visible; }
     
     // Position management
-    void setPosition(int newX, int newY) { x = newX; y = newY; }
+    void setPosition(int newX, int newY) { x = newX; y = newY; placePointerTarget(); }
     int getX() const { return x; }
     int getY() const { return y; }
     int getWidth() const { return width; }
     int getHeight() const { return height; }
     
     // Event callbacks
-    std::function<void(const CheckboxEvent&)> onStateChange;
-    std::function<void(const CheckboxEvent&)> onCheck;
-    std::function<void(const CheckboxEvent&)> onUncheck;
-    std::function<void(const MouseEvent&)> onHover;
-    std::function<void(const MouseEvent&)> onLeave;
-    std::function<void(const MouseEvent&)> onClick;
+    Delegate<void(const CheckboxEvent&)> onStateChange;
+    Delegate<void(const CheckboxEvent&)> onCheck;
+    Delegate<void(const CheckboxEvent&)> onUncheck;
+    Delegate<void(const MouseEvent&)> onHover;
+    Delegate<void(const MouseEvent&)> onLeave;
+    Delegate<void(const MouseEvent&)> onClick;
     
     // Event callback setters
-    void setOnStateChange(std::function<void(const CheckboxEvent&)> callback) { onStateChange = callback; }
-    void setOnCheck(std::function<void(const CheckboxEvent&)> callback) { onCheck = callback; }
-    void setOnUncheck(std::function<void(const CheckboxEvent&)> callback) { onUncheck = callback; }
-    void setOnHover(std::function<void(const MouseEvent&)> callback) { onHover = callback; }
-    void setOnLeave(std::function<void(const MouseEvent&)> callback) { onLeave = callback; }
-    void setOnClick(std::function<void(const MouseEvent&)> callback) { onClick = callback; }
+    void setOnStateChange(Delegate<void(const CheckboxEvent&)> callback) { onStateChange = std::move(callback); }
+    void setOnCheck(Delegate<void(const CheckboxEvent&)> callback) { onCheck = std::move(callback); }
+    void setOnUncheck(Delegate<void(const CheckboxEvent&)> callback) { onUncheck = std::move(callback); }
+    void setOnHover(Delegate<void(const MouseEvent&)> callback) { onHover = std::move(callback); }
+    void setOnLeave(Delegate<void(const MouseEvent&)> callback) { onLeave = std::move(callback); }
+    void setOnClick(Delegate<void(const MouseEvent&)> callback) { onClick = std::move(callback); }
 };
\ No newline at end of file
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+// Type-erased callable with the interface of std::function, except that
+// callables up to INLINE_SIZE bytes (lambdas capturing a few pointers, or
+// a whole std::function) live inside the delegate instead of on the heap.
+// Calling never allocates; copying allocates only for oversized callables.
+template <typename Signature>
+class Delegate;
+
+template <typename R, typename... Args>
+class Delegate<R(Args...)> {
+public:
+    enum { INLINE_SIZE = 4 * sizeof(void*) };
+
+private:
+    typedef typename std::aligned_storage<INLINE_SIZE, alignof(std::max_align_t)>::type Storage;
+    
+    struct Ops {
+        R (*invoke)(const Storage& storage, Args... args);
+        void (*copy)(Storage& dst, const Storage& src);
+        void (*move)(Storage& dst, Storage& src);      // Leaves src destroyed
+        void (*destroy)(Storage& storage);
+    };
+    
+    template <typename F>
+    struct Fits {
+        enum { value = sizeof(F) <= INLINE_SIZE && alignof(F) <= alignof(Storage) &&
+                       std::is_nothrow_move_constructible<F>::value };
+    };
+    
+    // Callables that fit are constructed in the storage
+    template <typename F, bool Inline = Fits<F>::value>
+    struct Manager {
+        static F& get(const Storage& s) { return *reinterpret_cast<F*>(const_cast<Storage*>(&s)); }
+        static void create(Storage& s, F&& f) { new (&s) F(std::move(f)); }
+        static R invoke(const Storage& s, Args... args) { return get(s)(std::forward<Args>(args)...); }
+        static void copy(Storage& d, const Storage& s) { new (&d) F(get(s)); }
+        static void move(Storage& d, Storage& s) {
+            new (&d) F(std::move(get(s)));
+            get(s).~F();
+        }
+        static void destroy(Storage& s) { get(s).~F(); }
+        static const Ops ops;
+    };
+    
+    // Larger ones are allocated once and the storage holds the pointer
+    template <typename F>
+    struct Manager<F, false> {
+        static F*& get(const Storage& s) { return *reinterpret_cast<F**>(const_cast<Storage*>(&s)); }
+        static void create(Storage& s, F&& f) { get(s) = new F(std::move(f)); }
+        static R invoke(const Storage& s, Args... args) { return (*get(s))(std::forward<Args>(args)...); }
+        static void copy(Storage& d, const Storage& s) { get(d) = new F(*get(s)); }
+        static void move(Storage& d, Storage& s) { get(d) = get(s); }
+        static void destroy(Storage& s) { delete get(s); }
+        static const Ops ops;
+    };
+    
+    Storage storage;
+    const Ops* ops;
+    
+    // Null function pointers and empty std::functions make an empty delegate
+    template <typename T>
+    static bool isNull(T* pointer) { return pointer == nullptr; }
+    template <typename S>
+    static bool isNull(const std::function<S>& function) { return !function; }
+    template <typename T>
+    static bool isNull(const T&) { return false; }
+
+public:
+    Delegate() : ops(nullptr) {}
+    Delegate(std::nullptr_t) : ops(nullptr) {}
+    
+    template <typename F, typename = typename std::enable_if<
+                  !std::is_same<typename std::decay<F>::type, Delegate>::value>::type>
+    Delegate(F&& f) : ops(nullptr) {
+        typedef typename std::decay<F>::type Callable;
+        if (isNull(f)) return;
+        Callable callable(std::forward<F>(f));
+        Manager<Callable>::create(storage, std::move(callable));
+        ops = &Manager<Callable>::ops;
+    }
+    
+    Delegate(const Delegate& other) : ops(other.ops) {
+        if (ops) ops->copy(storage, other.storage);
+    }
+    
+    // Moves never throw (inline callables must be nothrow-movable, the rest
+    // move a pointer), so containers of delegates move them on reallocation
+    Delegate(Delegate&& other) noexcept : ops(other.ops) {
+        if (ops) {
+            ops->move(storage, other.storage);
+            other.ops = nullptr;
+        }
+    }
+    
+    ~Delegate() { reset(); }
+    
+    Delegate& operator=(const Delegate& other) {
+        if (this != &other) *this = Delegate(other);
+        return *this;
+    }
+    
+    Delegate& operator=(Delegate&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.ops) {
+                other.ops->move(storage, other.storage);
+                ops = other.ops;
+                other.ops = nullptr;
+            }
+        }
+        return *this;
+    }
+    
+    Delegate& operator=(std::nullptr_t) {
+        reset();
+        return *this;
+    }
+    
+    void reset() {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+    
+    explicit operator bool() const { return ops != nullptr; }
+    
+    R operator()(Args... args) const {
+        return ops->invoke(storage, std::forward<Args>(args)...);
+    }
+};
+
+template <typename R, typename... Args>
+template <typename F, bool Inline>
+const typename Delegate<R(Args...)>::Ops Delegate<R(Args...)>::Manager<F, Inline>::ops = {
+    &Manager<F, Inline>::invoke, &Manager<F, Inline>::copy, &Manager<F, Inline>::move, &Manager<F, Inline>::destroy
+};
+
+template <typename R, typename... Args>
+template <typename F>
+const typename Delegate<R(Args...)>::Ops Delegate<R(Args...)>::Manager<F, false>::ops = {
+    &Manager<F, false>::invoke, &Manager<F, false>::copy, &Manager<F, false>::move, &Manager<F, false>::destroy
+};
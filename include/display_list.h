@@ -0,0 +1,86 @@
+#pragma once
+
+#include "buffer.h"
+#include "region.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+// Retained record of the drawing calls made on a UnicodeBuffer between
+// beginRecording() and endRecording(). Coordinates and clips are relative to
+// the origin recording started at, and styles are kept as strings, so a list
+// can be replayed into any buffer at any translation.
+class DisplayList {
+public:
+    enum Op : uint8_t {
+        OP_CELL,
+        OP_HLINE,
+        OP_VLINE,
+        OP_TEXT,
+        OP_RECT,
+        OP_BOX
+    };
+    
+    enum : uint8_t {
+        BOX_ROUNDED = 1,
+        BOX_HEAVY = 2
+    };
+    
+    struct Command {
+        Op op;
+        uint8_t flags;           // BOX_* for boxes
+        uint16_t style;          // Index into the list's style table
+        int x, y;
+        int w, h;                // Length in w for lines, limit X in w for text
+        uint32_t glyph;
+        uint32_t textOffset, textLength;
+        Rect clip;
+        Rect extent;             // Cells the command can touch, clip applied
+    };
+    
+    DisplayList() : mapTarget(0) { clear(); }
+    
+    void clear();
+    bool empty() const { return commands.empty(); }
+    size_t size() const { return commands.size(); }
+    const std::vector<Command>& getCommands() const { return commands; }
+    const std::string& styleString(uint16_t style) const { return styles[style]; }
+    const char* text(const Command& command) const { return textPool.data() + command.textOffset; }
+    // Union of all command extents
+    Rect getBounds() const;
+    
+    // Appends the extents of the commands that differ between two lists.
+    // Cells outside them come out the same whichever list is replayed.
+    static void diff(const DisplayList& before, const DisplayList& after, std::vector<Rect>& out);
+    
+    // Flat little-endian encoding of the list. deserialize() returns false
+    // and leaves the list empty if the data is malformed.
+    void serialize(std::string& out) const;
+    bool deserialize(const char* data, size_t size);
+    
+    // Called by UnicodeBuffer while recording; coordinates and clip are in
+    // recording space
+    void recordCell(const Rect& clip, int x, int y, uint32_t glyph, const std::string& color);
+    void recordHLine(const Rect& clip, int x, int y, int length, uint32_t glyph, const std::string& color);
+    void recordVLine(const Rect& clip, int x, int y, int length, uint32_t glyph, const std::string& color);
+    void recordText(const Rect& clip, int x, int y, const std::string& text, const std::string& color, int limitX);
+    void recordRect(const Rect& clip, int x, int y, int w, int h, uint32_t glyph, const std::string& color);
+    void recordBox(const Rect& clip, int x, int y, int w, int h, const std::string& color, bool rounded, bool heavy);
+    
+    // Style ids for `buffer`, interned on first use and cached per buffer
+    const StyleId* styleMap(UnicodeBuffer& buffer) const;
+
+private:
+    std::vector<Command> commands;
+    std::string textPool;
+    std::vector<std::string> styles;
+    std::unordered_map<std::string, uint16_t> styleLookup;
+    
+    mutable std::vector<StyleId> mappedStyles;
+    mutable uint32_t mapTarget;
+    
+    uint16_t internStyle(const std::string& color);
+    void add(Command& command, const std::string& color);
+    bool sameCommand(const Command& a, const DisplayList& other, const Command& b) const;
+};
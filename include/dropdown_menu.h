@@ -3,6 +3,7 @@
 #include "buffer.h"
 #include "mouse_handler.h"
 #include "colors.h"
+#include "event_system.h"
 #include <vector>
 #include <string>
 #include <functional>
@@ -23,9 +24,25 @@ struct MenuItem {
         : text(text), shortcut(shortcut), callback(callback), enabled(enabled), separator(separator) {}
 };
 
+// Menu events
+class MenuEvent : public Event {
+public:
+    std::weak_ptr<class DropdownMenu> menu;
+    std::string menuTitle;
+    int itemIndex;               // -1 for MENU_OPEN / MENU_CLOSE
+    std::string itemText;
+    std::string itemShortcut;
+    int mouseX, mouseY;
+    
+    MenuEvent(EventType type, std::shared_ptr<class DropdownMenu> menu, const std::string& title);
+    MenuEvent(EventType type, std::shared_ptr<class DropdownMenu> menu, const std::string& title,
+              int itemIndex, const std::string& itemText, const std::string& itemShortcut);
+};
+
 // Dropdown menu component
 class DropdownMenu {
 private:
+    uint32_t id;                 // Owner of the trigger and popup cells
     std::vector<MenuItem> items;
     int x, y;                    // Position of menu
     int width, height;           // Calculated dimensions
@@ -40,12 +57,22 @@ private:
     bool wasLeftPressed;
     bool menuOpen;
     
+    // Event state from the previous update
+    int lastHoveredIndex;
+    bool wasMenuOpen;
+    
+    // Trigger drawn as part of a full-width application menu bar
+    bool isApplicationMenuBar;
+    int menuBarWidth;
+    
     void calculateDimensions();
     void drawTrigger(UnicodeBuffer& buffer);
     void drawMenu(UnicodeBuffer& buffer);
     bool triggerContains(int mx, int my) const;
     bool menuContains(int mx, int my) const;
     int getItemAtPosition(int mx, int my) const;
+    void generateMenuEvent(EventType type);
+    void generateItemEvent(EventType type, int itemIndex, int mouseX = 0, int mouseY = 0);
     
 public:
     DropdownMenu(int x, int y, const std::string& title);
@@ -65,6 +92,13 @@ public:
     // Static utility for drawing menu bar background
     static void drawMenuBar(UnicodeBuffer& buffer, int y, int termWidth);
     
+    // Application menu bar: menus sharing a row drawn over one full-width bar
+    void drawApplicationMenuBar(UnicodeBuffer& buffer);
+    static void setupApplicationMenuBar(std::vector<std::shared_ptr<DropdownMenu>>& menus, int y, int termWidth);
+    static void drawApplicationMenuBars(std::vector<std::shared_ptr<DropdownMenu>>& menus, UnicodeBuffer& buffer, int termWidth);
+    void setAsApplicationMenuBar(bool enable, int width) { isApplicationMenuBar = enable; menuBarWidth = width; }
+    bool isAppMenuBar() const { return isApplicationMenuBar; }
+    
     // Collision detection and avoidance
     static void adjustMenuPositions(std::vector<std::shared_ptr<DropdownMenu>>& menus, int termWidth);
     
@@ -92,4 +126,21 @@ public:
     int getWidth() const { return width; }
     int getHeight() const { return height; }
     int getSelectedIndex() const { return selectedIndex; }
+    uint32_t getId() const { return id; }
+    
+    // Event callbacks
+    Delegate<void(const MenuEvent&)> onMenuOpen;
+    Delegate<void(const MenuEvent&)> onMenuClose;
+    Delegate<void(const MenuEvent&)> onItemHover;
+    Delegate<void(const MenuEvent&)> onItemLeave;
+    Delegate<void(const MenuEvent&)> onItemSelect;
+    Delegate<void(const MenuEvent&)> onItemClick;
+    
+    // Event callback setters
+    void setOnMenuOpen(Delegate<void(const MenuEvent&)> callback) { onMenuOpen = std::move(callback); }
+    void setOnMenuClose(Delegate<void(const MenuEvent&)> callback) { onMenuClose = std::move(callback); }
+    void setOnItemHover(Delegate<void(const MenuEvent&)> callback) { onItemHover = std::move(callback); }
+    void setOnItemLeave(Delegate<void(const MenuEvent&)> callback) { onItemLeave = std::move(callback); }
+    void setOnItemSelect(Delegate<void(const MenuEvent&)> callback) { onItemSelect = std::move(callback); }
+    void setOnItemClick(Delegate<void(const MenuEvent&)> callback) { onItemClick = std::move(callback); }
 };
\ No newline at end of file
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "delegate.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+enum class EventType : uint8_t {
+    // Mouse
+    MOUSE_MOVE,
+    MOUSE_PRESS,
+    MOUSE_RELEASE,
+    MOUSE_DRAG,
+    MOUSE_ENTER,
+    MOUSE_LEAVE,
+    MOUSE_WHEEL,
+    
+    // Keyboard
+    KEY_PRESS,
+    KEY_RELEASE,
+    
+    // Windows
+    WINDOW_FOCUS,
+    WINDOW_BLUR,
+    WINDOW_MOVE,
+    WINDOW_RESIZE,
+    WINDOW_CLOSE,
+    SCROLL_CHANGE,
+    
+    // Buttons and toggles
+    BUTTON_CLICK,
+    BUTTON_PRESS,
+    BUTTON_RELEASE,
+    BUTTON_TOGGLE,
+    
+    // Menus
+    MENU_OPEN,
+    MENU_CLOSE,
+    MENU_ITEM_HOVER,
+    MENU_ITEM_LEAVE,
+    MENU_ITEM_SELECT,
+    MENU_ITEM_CLICK,
+    
+    COUNT
+};
+
+// Base of every event. Input events are plain values with no virtual
+// functions, so they can be queued by copying bytes; widget events derive
+// from it to add their payload.
+struct Event {
+    EventType type;
+    
+    Event() = default;
+    explicit Event(EventType type) : type(type) {}
+};
+
+struct MouseEvent : Event {
+    int x, y;
+    int button;                  // 0 left, 1 middle, 2 right, -1 none
+    int deltaX, deltaY;          // MOUSE_WHEEL: lines to scroll, positive right/down
+    
+    MouseEvent() = default;
+    MouseEvent(EventType type, int x, int y, int button = -1)
+        : Event(type), x(x), y(y), button(button), deltaX(0), deltaY(0) {}
+};
+
+struct KeyboardEvent : Event {
+    char ch;
+    int keyCode;
+    
+    KeyboardEvent() = default;
+    KeyboardEvent(EventType type, char ch, int keyCode) : Event(type), ch(ch), keyCode(keyCode) {}
+};
+
+static_assert(std::is_trivially_copyable<MouseEvent>::value && std::is_trivially_copyable<KeyboardEvent>::value,
+              "input events are queued by value");
+
+// Process-wide event bus. Listeners are delegates kept in one flat array
+// per event type, so dispatching never allocates as long as the listeners'
+// captures fit in a Delegate. Input events can also be posted to a ring
+// queue of fixed-size slots that is drained once per frame.
+class EventManager {
+public:
+    typedef Delegate<void(const Event&)> Listener;
+    typedef uint32_t ListenerId;
+    
+    static EventManager& getInstance();
+    EventManager(const EventManager&) = delete;
+    EventManager& operator=(const EventManager&) = delete;
+    
+    // Listeners added during a dispatch first run on the next event
+    ListenerId subscribe(EventType type, Listener listener);
+    void unsubscribe(ListenerId id);
+    size_t getListenerCount(EventType type) const;
+    
+    // Calls the listeners for event.type right away
+    void dispatch(const Event& event);
+    template <typename T>
+    void dispatchEvent(std::unique_ptr<T> event) {
+        if (event) dispatch(*event);
+    }
+    
+    // Copy an input event into the queue for processQueue()
+    void post(const MouseEvent& event);
+    void post(const KeyboardEvent& event);
+    // Dispatches the events queued before the call; events posted by
+    // listeners wait for the next call. Returns how many were dispatched.
+    size_t processQueue();
+    size_t getQueuedCount() const { return queueCount; }
+
+private:
+    // Ids carry the event type in the low byte; 0 marks an entry
+    // unsubscribed during a dispatch, removed once it ends
+    struct Entry {
+        ListenerId id;
+        Listener listener;
+    };
+    
+    // Fixed-size slot holding any input event
+    struct QueuedEvent {
+        enum Kind : uint8_t { MOUSE, KEYBOARD } kind;
+        union {
+            MouseEvent mouse;
+            KeyboardEvent keyboard;
+        };
+    };
+    
+    std::vector<Entry> listeners[(size_t)EventType::COUNT];
+    std::vector<Entry> added;        // Subscribed during a dispatch
+    ListenerId nextSerial;
+    int dispatchDepth;
+    bool removedDuringDispatch;
+    
+    // Ring of queued events; the capacity is a power of two and only grows
+    std::vector<QueuedEvent> queue;
+    size_t queueHead, queueCount;
+    
+    EventManager();
+    QueuedEvent& pushSlot();
+    void flushPendingChanges();
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "region.h"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+// Uniform grid over the screen mapping points to the topmost of a set of
+// rectangular hit targets. Each grid bucket lists the targets overlapping
+// it, highest first, so a point query looks at one bucket and stops at the
+// first target containing the point. Targets are updated one at a time as
+// their geometry or stacking changes.
+class HitIndex {
+public:
+    enum { BUCKET_WIDTH = 16, BUCKET_HEIGHT = 8 };
+    
+    HitIndex() : width(0), height(0), columns(0), rows(0), sequence(0) {}
+    
+    // Screen size; everything outside it is ignored. Keeps the targets.
+    void resize(int w, int h);
+    void clear();
+    
+    // Add or move target `id` (non-zero). Higher depth is on top; equal
+    // depths resolve to the one set last. An empty rect removes the target.
+    void set(uint32_t id, const Rect& rect, uint32_t depth);
+    void remove(uint32_t id);
+    bool containsTarget(uint32_t id) const { return slots.count(id) != 0; }
+    size_t size() const { return slots.size(); }
+    
+    // Topmost target containing (x, y), or 0
+    uint32_t query(int x, int y) const;
+
+private:
+    struct Target {
+        uint32_t id;
+        uint32_t depth;
+        uint32_t sequence;           // Breaks depth ties in favor of newer
+        Rect rect;
+    };
+    
+    int width, height;
+    int columns, rows;
+    std::vector<Target> targets;
+    std::unordered_map<uint32_t, uint32_t> slots;   // id -> index in targets
+    std::vector<uint32_t> freeSlots;
+    std::vector<std::vector<uint32_t>> buckets;     // Target indices, topmost first
+    uint32_t sequence;
+    
+    bool above(uint32_t a, uint32_t b) const;
+    void link(uint32_t slot);
+    void unlink(uint32_t slot);
+    Rect bucketRange(const Rect& rect) const;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "asm_optimized.h"
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+
+// One recorded input: a decoded SGR mouse report or a terminal size
+// change, stamped in microseconds since recording started. Recording and
+// replay both read ASMOptimized::monotonic_ns(), the clock the frame
+// timings are calibrated against.
+struct InputRecord {
+    enum Kind : uint8_t { MOUSE = 1, RESIZE = 2 };
+    
+    Kind kind;
+    uint64_t time;
+    ASMOptimized::SGRMouseEvent mouse;   // MOUSE
+    int width, height;                   // RESIZE
+};
+
+// Writes the input stream to a file as it is decoded. After a "TUIR"
+// magic and a version byte, each record is a kind byte (bit 7 set for a
+// mouse press), the microseconds since the previous record and the
+// payload, all numbers as LEB128 varints: a mouse motion report is
+// usually 5-6 bytes. Records go through stdio buffering, which exit()
+// still flushes when the session ends on q or a signal.
+class InputRecorder {
+public:
+    InputRecorder() : file(nullptr), start(0), lastTime(0) {}
+    ~InputRecorder() { close(); }
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+    
+    // Starts a new file, replacing any; false if it cannot be created
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file != nullptr; }
+    
+    void recordMouse(const ASMOptimized::SGRMouseEvent& event);
+    void recordResize(int width, int height);
+
+private:
+    FILE* file;
+    uint64_t start;              // monotonic_ns() when the file was opened
+    uint64_t lastTime;
+    
+    void begin(uint8_t kind);
+    void putVarint(uint64_t value);
+};
+
+// Plays a recording back. Real time hands out records as wall-clock time
+// passes; otherwise each advance() moves the replay clock by a fixed frame
+// interval, so a recording always splits into the same frames however
+// fast they are rendered.
+class InputReplay {
+public:
+    InputReplay() : position(0), clock(0), frameMicros(16000), realTime(false), startedAt(0) {}
+    
+    // Reads the whole file; false if it is missing or not a recording
+    bool open(const std::string& path);
+    // Rewinds and sets the pacing
+    void start(bool realTime, uint64_t frameMicros = 16000);
+    
+    // Move the clock to the next frame
+    void advance();
+    // The next record due by the clock, or null once none is
+    const InputRecord* next();
+    bool finished() const { return position >= records.size(); }
+    bool isRealTime() const { return realTime; }
+    size_t size() const { return records.size(); }
+    // Recorded time covered, in microseconds
+    uint64_t getDuration() const { return records.empty() ? 0 : records.back().time; }
+
+private:
+    std::vector<InputRecord> records;
+    size_t position;
+    uint64_t clock;
+    uint64_t frameMicros;
+    bool realTime;
+    uint64_t startedAt;          // monotonic_ns() at start()
+};
@@ -4,6 +4,7 @@
 #include "mouse_handler.h"
 #include "colors.h"
 #include "event_system.h"
+#include "pointer_tracker.h"
 #include <string>
 #include <vector>
 #include <functional>
@@ -68,13 +69,16 @@ private:
     bool multiSelect;
     std::vector<bool> selectedItems;
     
-    // Mouse interaction
-    bool wasLeftPressed;
+    // Mouse interaction; hover and clicks arrive from the PointerTracker
+    PointerTarget pointer;
     int hoveredIndex;
     bool dragging;
     
     void generateListEvent(EventType type, int itemIndex);
     void calculateDimensions();
+    void handlePointer(const MouseEvent& event);
+    void setHoveredIndex(int index);
+    void placePointerTarget();
     int getItemAtPosition(int mx, int my) const;
     void ensureItemVisible(int index);
     void updateScrollbar();
@@ -122,6 +126,8 @@ public:
     void scrollToTop();
     void scrollToBottom();
     void scrollToItem(int index);
+    // Positive scrolls down; clamped to the items
+    void scrollBy(int lines);
     int getScrollOffset() const { return scrollOffset; }
     int getVisibleItemCount() const;
     
@@ -144,18 +150,17 @@ public:
     void setShowScrollbar(bool show) { showScrollbar = show; }
     
     // Interaction
-    void updateMouse(FastMouseHandler& mouse, int termWidth, int termHeight);
     void handleKeyboard(char ch, int keyCode);
     bool contains(int mx, int my) const;
     
     // Rendering
     void draw(UnicodeBuffer& buffer);
-    void show() { visible = true; }
-    void hide() { visible = false; }
+    void show() { visible = true; placePointerTarget(); }
+    void hide() { visible = false; placePointerTarget(); }
     bool isVisible() const { return visible; }
     
     // Position management
-    void setPosition(int newX, int newY) { x = newX; y = newY; }
+    void setPosition(int newX, int newY) { x = newX; y = newY; placePointerTarget(); }
     void setSize(int newWidth, int newHeight) { width = newWidth; height = newHeight; calculateDimensions(); }
     int getX() const { return x; }
     int getY() const { return y; }
@@ -163,22 +168,22 @@ public:
     int getHeight() const { return height; }
     
     // Event callbacks
-    std::function<void(const ListBoxEvent&)> onSelectionChange;
-    std::function<void(const ListBoxEvent&)> onItemSelect;
-    std::function<void(const ListBoxEvent&)> onItemDoubleClick;
-    std::function<void(const ListBoxEvent&)> onItemHover;
-    std::function<void(const ListBoxEvent&)> onItemLeave;
-    std::function<void(const MouseEvent&)> onScroll;
-    std::function<void(const MouseEvent&)> onHover;
-    std::function<void(const MouseEvent&)> onLeave;
+    Delegate<void(const ListBoxEvent&)> onSelectionChange;
+    Delegate<void(const ListBoxEvent&)> onItemSelect;
+    Delegate<void(const ListBoxEvent&)> onItemDoubleClick;
+    Delegate<void(const ListBoxEvent&)> onItemHover;
+    Delegate<void(const ListBoxEvent&)> onItemLeave;
+    Delegate<void(const MouseEvent&)> onScroll;
+    Delegate<void(const MouseEvent&)> onHover;
+    Delegate<void(const MouseEvent&)> onLeave;
     
     // Event callback setters
-    void setOnSelectionChange(std::function<void(const ListBoxEvent&)> callback) { onSelectionChange = callback; }
-    void setOnItemSelect(std::function<void(const ListBoxEvent&)> callback) { onItemSelect = callback; }
-    void setOnItemDoubleClick(std::function<void(const ListBoxEvent&)> callback) { onItemDoubleClick = callback; }
-    void setOnItemHover(std::function<void(const ListBoxEvent&)> callback) { onItemHover = callback; }
-    void setOnItemLeave(std::function<void(const ListBoxEvent&)> callback) { onItemLeave = callback; }
-    void setOnScroll(std::function<void(const MouseEvent&)> callback) { onScroll = callback; }
-    void setOnHover(std::function<void(const MouseEvent&)> callback) { onHover = callback; }
-    void setOnLeave(std::function<void(const MouseEvent&)> callback) { onLeave = callback; }
+    void setOnSelectionChange(Delegate<void(const ListBoxEvent&)> callback) { onSelectionChange = std::move(callback); }
+    void setOnItemSelect(Delegate<void(const ListBoxEvent&)> callback) { onItemSelect = std::move(callback); }
+    void setOnItemDoubleClick(Delegate<void(const ListBoxEvent&)> callback) { onItemDoubleClick = std::move(callback); }
+    void setOnItemHover(Delegate<void(const ListBoxEvent&)> callback) { onItemHover = std::move(callback); }
+    void setOnItemLeave(Delegate<void(const ListBoxEvent&)> callback) { onItemLeave = std::move(callback); }
+    void setOnScroll(Delegate<void(const MouseEvent&)> callback) { onScroll = std::move(callback); }
+    void setOnHover(Delegate<void(const MouseEvent&)> callback) { onHover = std::move(callback); }
+    void setOnLeave(Delegate<void(const MouseEvent&)> callback) { onLeave = std::move(callback); }
 };
\ No newline at end of file
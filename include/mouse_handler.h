@@ -1,6 +1,9 @@
 #pragma once
 
+#include "asm_optimized.h"
+#include "input_recorder.h"
 #include <string>
+#include <vector>
 #include <termios.h>
 #include <unistd.h>
 
@@ -15,14 +18,55 @@ private:
     bool leftPressed = false;
     int currentX = 0, currentY = 0;
     
+    // Wheel ticks since the start of the last updateMouse(), so a burst
+    // of ticks within one frame scrolls once
+    int wheelTicksX = 0, wheelTicksY = 0;
+    int wheelLinesPerTick = 1;
+    bool wheelAcceleration = false;
+    
+    // Reply to a Primary Device Attributes query (CSI ? Ps ; ... c)
+    std::vector<int> deviceAttributes;
+    bool deviceAttributesReceived = false;
+    
+    InputRecorder* recorder = nullptr;
+    
     void processAllAvailableInput();
-    void parseMouseData(const std::string& data, bool isPress);
+    void applyMouseEvent(const ASMOptimized::SGRMouseEvent& event);
+    int wheelLines(int ticks) const;
     
 public:
     void enableMouse();
+    // Start a frame: reset the wheel counters and read what stdin has
     void updateMouse();
+    // Start a frame without reading stdin, for input injected instead
+    void beginFrame();
+    // Apply a decoded report as if it had just been read, e.g. from a replay
+    void injectMouseEvent(const ASMOptimized::SGRMouseEvent& event) { applyMouseEvent(event); }
+    // Decoded reports are also written to `recorder` while it is set
+    void setRecorder(InputRecorder* inputRecorder) { recorder = inputRecorder; }
+    
+    // Decode raw terminal input; returns bytes consumed (an incomplete
+    // trailing report is left for the next call)
+    size_t feedInput(const char* data, size_t length);
     
     int getMouseX() const { return currentX; }
     int getMouseY() const { return currentY; }
     bool isLeftButtonPressed() const { return leftPressed; }
+    
+    // Wheel ticks decoded by the last updateMouse(), negative up or left.
+    // Shift+wheel scrolls horizontally, as do terminals' tilt buttons.
+    int getWheelTicksX() const { return wheelTicksX; }
+    int getWheelTicksY() const { return wheelTicksY; }
+    // The same ticks as lines to scroll
+    int getWheelDeltaX() const { return wheelLines(wheelTicksX); }
+    int getWheelDeltaY() const { return wheelLines(wheelTicksY); }
+    // With acceleration, a frame with n ticks scrolls up to 4x further per
+    // tick, so fast spins cover long content
+    void setWheelScrolling(int linesPerTick, bool accelerate) {
+        wheelLinesPerTick = linesPerTick;
+        wheelAcceleration = accelerate;
+    }
+    
+    bool hasDeviceAttributes() const { return deviceAttributesReceived; }
+    const std::vector<int>& getDeviceAttributes() const { return deviceAttributes; }
 };
\ No newline at end of file
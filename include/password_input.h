@@ -45,9 +45,9 @@ public:
     void setText(const std::string& newText);
     
     // Additional password-specific callbacks
-    std::function<void(const TextInputEvent&)> onPasswordStrengthChange;
-    std::function<void(const TextInputEvent&)> onPasswordToggle;
+    Delegate<void(const TextInputEvent&)> onPasswordStrengthChange;
+    Delegate<void(const TextInputEvent&)> onPasswordToggle;
     
-    void setOnPasswordStrengthChange(std::function<void(const TextInputEvent&)> callback) { onPasswordStrengthChange = callback; }
-    void setOnPasswordToggle(std::function<void(const TextInputEvent&)> callback) { onPasswordToggle = callback; }
+    void setOnPasswordStrengthChange(Delegate<void(const TextInputEvent&)> callback) { onPasswordStrengthChange = std::move(callback); }
+    void setOnPasswordToggle(Delegate<void(const TextInputEvent&)> callback) { onPasswordToggle = std::move(callback); }
 };
\ No newline at end of file
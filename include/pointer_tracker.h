@@ -0,0 +1,109 @@
+#pragma once
+
+#include "event_system.h"
+#include "hit_index.h"
+#include "region.h"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Hover, press and focus state for the pointer, kept in one place instead
+// of in every widget. Targets are top-level (windows, placed in screen
+// coordinates) or children (widgets, placed relative to their parent's
+// rect, so a moved window carries its widgets along). update() resolves
+// the pointer to the deepest target under it and sends events only to the
+// targets involved:
+//   MOUSE_ENTER / MOUSE_LEAVE   the hovered target changed
+//   MOUSE_MOVE                  the pointer moved within the hovered target
+//   MOUSE_PRESS                 the left button went down over the target
+//   MOUSE_DRAG                  the pointer moved while the target holds the press
+//   MOUSE_RELEASE               the button came up; sent to the pressed target
+//   BUTTON_CLICK                ...and the pointer was still over it
+//   WINDOW_FOCUS / WINDOW_BLUR  a press moved the focus
+//   MOUSE_WHEEL                 from wheel(), to the innermost scrollable
+//                               target under the pointer
+// Event coordinates are screen cells. A frame in which neither the pointer
+// nor any target moved costs a few compares.
+class PointerTracker {
+public:
+    typedef Delegate<void(const MouseEvent&)> Handler;
+    
+    static PointerTracker& getInstance();
+    PointerTracker(const PointerTracker&) = delete;
+    PointerTracker& operator=(const PointerTracker&) = delete;
+    
+    // Screen size; top-level targets outside it cannot be hit
+    void resize(int w, int h);
+    
+    // Register `id` (non-zero and unique, e.g. from allocateOwnerId())
+    // under `parent`, or at top level with parent 0. The handler may be
+    // empty. New targets have an empty rect until setTargetRect(). A parent
+    // not registered yet is created at top level by its first child.
+    void addTarget(uint32_t id, uint32_t parent, Handler handler);
+    // Higher depth is on top among siblings, ties go to the later sibling.
+    // An empty rect makes the target unreachable.
+    void setTargetRect(uint32_t id, const Rect& rect, uint32_t depth = 0);
+    // Children of a removed target become unreachable
+    void removeTarget(uint32_t id);
+    // Scrollable targets take the wheel over the targets they contain
+    void setScrollable(uint32_t id, bool scrollable);
+    
+    // Feed the pointer position and left button once per frame
+    void update(int x, int y, bool leftPressed);
+    // Feed the frame's wheel motion, after update(); does nothing for 0, 0
+    void wheel(int deltaX, int deltaY);
+    
+    // Deepest target at a screen cell, or 0
+    uint32_t targetAt(int x, int y) const;
+    // Top-level target at a screen cell, or 0
+    uint32_t topLevelAt(int x, int y) const { return index.query(x, y); }
+    
+    uint32_t getHovered() const { return hovered; }
+    uint32_t getPressed() const { return pressed; }
+    uint32_t getFocused() const { return focused; }
+    // Move the focus without a press, e.g. from the keyboard
+    void setFocus(uint32_t id);
+
+private:
+    struct Target {
+        Target() : parent(0), depth(0), scrollable(false) {}
+        
+        uint32_t parent;
+        Rect rect;
+        uint32_t depth;
+        bool scrollable;
+        Handler handler;
+        std::vector<uint32_t> children;
+    };
+    
+    std::unordered_map<uint32_t, Target> targets;
+    HitIndex index;              // Top-level targets
+    uint64_t layoutVersion;      // Bumped whenever a target may have moved
+    uint64_t seenLayoutVersion;
+    int lastX, lastY;
+    bool lastPressed;
+    uint32_t hovered, pressed, focused;
+    
+    PointerTracker();
+    void send(uint32_t id, EventType type, int x, int y, int button = -1);
+};
+
+// A widget's registration with the PointerTracker, dropped with the widget
+class PointerTarget {
+public:
+    PointerTarget() : id(0) {}
+    ~PointerTarget() { detach(); }
+    PointerTarget(const PointerTarget&) = delete;
+    PointerTarget& operator=(const PointerTarget&) = delete;
+    
+    // Registers under `parent` with a fresh id
+    void attach(uint32_t parent, PointerTracker::Handler handler);
+    void detach();
+    // Rect relative to the parent's; empty while the widget cannot be hit
+    void place(const Rect& rect, uint32_t depth = 0);
+    void setScrollable(bool scrollable);
+    uint32_t getId() const { return id; }
+
+private:
+    uint32_t id;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "buffer.h"
+#include "terminal_output.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <vector>
+
+// Runs TerminalOutput::present() on its own thread so a slow terminal or
+// SSH link never blocks input handling or composition. submit() snapshots
+// the frame into one of three buffers and returns; the thread presents the
+// newest snapshot. A frame submitted while another is still waiting
+// replaces it, so a writer that falls behind skips frames instead of
+// queueing them.
+class PresentThread {
+private:
+    struct PendingCopy {
+        Rect source;
+        int dstX, dstY;
+    };
+    
+    TerminalOutput& output;
+    
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    
+    // Slots being presented and waiting to be presented (-1 if none); the
+    // third is free for the next submit()
+    std::unique_ptr<UnicodeBuffer> slots[3];
+    int presenting, pending;
+    bool stopping;
+    
+    // TerminalOutput calls made by the UI thread, applied by the present
+    // thread before the frame they belong to
+    std::vector<PendingCopy> nextCopies;     // For the next submitted frame
+    std::vector<PendingCopy> pendingCopies;  // For the waiting frame
+    std::vector<int> attributes;
+    bool attributesPending;
+    
+    size_t presentedFrames, supersededFrames;
+    
+    std::thread thread;
+    
+    void run();
+
+public:
+    explicit PresentThread(TerminalOutput& output);
+    // Presents the waiting frame, if any, then stops the thread
+    ~PresentThread();
+    PresentThread(const PresentThread&) = delete;
+    PresentThread& operator=(const PresentThread&) = delete;
+    
+    // Queue `frame` for presenting, superseding a frame still waiting
+    void submit(const UnicodeBuffer& frame);
+    // Counterparts of the TerminalOutput calls, applied in frame order
+    void copyRect(const Rect& source, int dstX, int dstY);
+    void handleDeviceAttributes(const std::vector<int>& attributes);
+    // Block until every submitted frame has been presented or superseded
+    void waitIdle();
+    
+    size_t getPresentedFrames();
+    size_t getSupersededFrames();
+};
@@ -106,18 +106,18 @@ public:
     int getHeight() const { return height; }
     
     // Event callbacks
-    std::function<void(const ProgressBarEvent&)> onValueChange;
-    std::function<void(const ProgressBarEvent&)> onComplete;
-    std::function<void(const MouseEvent&)> onHover;
-    std::function<void(const MouseEvent&)> onLeave;
-    std::function<void(const MouseEvent&)> onClick;
-    std::function<void(const MouseEvent&)> onDrag;
+    Delegate<void(const ProgressBarEvent&)> onValueChange;
+    Delegate<void(const ProgressBarEvent&)> onComplete;
+    Delegate<void(const MouseEvent&)> onHover;
+    Delegate<void(const MouseEvent&)> onLeave;
+    Delegate<void(const MouseEvent&)> onClick;
+    Delegate<void(const MouseEvent&)> onDrag;
     
     // Event callback setters
-    void setOnValueChange(std::function<void(const ProgressBarEvent&)> callback) { onValueChange = callback; }
-    void setOnComplete(std::function<void(const ProgressBarEvent&)> callback) { onComplete = callback; }
-    void setOnHover(std::function<void(const MouseEvent&)> callback) { onHover = callback; }
-    void setOnLeave(std::function<void(const MouseEvent&)> callback) { onLeave = callback; }
-    void setOnClick(std::function<void(const MouseEvent&)> callback) { onClick = callback; }
-    void setOnDrag(std::function<void(const MouseEvent&)> callback) { onDrag = callback; }
+    void setOnValueChange(Delegate<void(const ProgressBarEvent&)> callback) { onValueChange = std::move(callback); }
+    void setOnComplete(Delegate<void(const ProgressBarEvent&)> callback) { onComplete = std::move(callback); }
+    void setOnHover(Delegate<void(const MouseEvent&)> callback) { onHover = std::move(callback); }
+    void setOnLeave(Delegate<void(const MouseEvent&)> callback) { onLeave = std::move(callback); }
+    void setOnClick(Delegate<void(const MouseEvent&)> callback) { onClick = std::move(callback); }
+    void setOnDrag(Delegate<void(const MouseEvent&)> callback) { onDrag = std::move(callback); }
 };
\ No newline at end of file
@@ -129,16 +129,16 @@ public:
     int getHeight() const { return height; }
     
     // Event callbacks
-    std::function<void(const RadioButtonEvent&)> onSelectionChange;
-    std::function<void(const RadioButtonEvent&)> onItemSelect;
-    std::function<void(const MouseEvent&)> onItemHover;
-    std::function<void(const MouseEvent&)> onItemLeave;
-    std::function<void(const MouseEvent&)> onClick;
+    Delegate<void(const RadioButtonEvent&)> onSelectionChange;
+    Delegate<void(const RadioButtonEvent&)> onItemSelect;
+    Delegate<void(const MouseEvent&)> onItemHover;
+    Delegate<void(const MouseEvent&)> onItemLeave;
+    Delegate<void(const MouseEvent&)> onClick;
     
     // Event callback setters
-    void setOnSelectionChange(std::function<void(const RadioButtonEvent&)> callback) { onSelectionChange = callback; }
-    void setOnItemSelect(std::function<void(const RadioButtonEvent&)> callback) { onItemSelect = callback; }
-    void setOnItemHover(std::function<void(const MouseEvent&)> callback) { onItemHover = callback; }
-    void setOnItemLeave(std::function<void(const MouseEvent&)> callback) { onItemLeave = callback; }
-    void setOnClick(std::function<void(const MouseEvent&)> callback) { onClick = callback; }
+    void setOnSelectionChange(Delegate<void(const RadioButtonEvent&)> callback) { onSelectionChange = std::move(callback); }
+    void setOnItemSelect(Delegate<void(const RadioButtonEvent&)> callback) { onItemSelect = std::move(callback); }
+    void setOnItemHover(Delegate<void(const MouseEvent&)> callback) { onItemHover = std::move(callback); }
+    void setOnItemLeave(Delegate<void(const MouseEvent&)> callback) { onItemLeave = std::move(callback); }
+    void setOnClick(Delegate<void(const MouseEvent&)> callback) { onClick = std::move(callback); }
 };
\ No newline at end of file
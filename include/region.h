@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+// Axis-aligned cell rectangle in screen coordinates
+struct Rect {
+    int x, y, w, h;
+    
+    Rect() : x(0), y(0), w(0), h(0) {}
+    Rect(int x, int y, int w, int h) : x(x), y(y), w(w), h(h) {}
+    
+    bool empty() const { return w <= 0 || h <= 0; }
+    bool contains(int px, int py) const { return px >= x && px < x + w && py >= y && py < y + h; }
+    Rect intersect(const Rect& other) const;
+    
+    bool operator==(const Rect& other) const {
+        return x == other.x && y == other.y && w == other.w && h == other.h;
+    }
+    bool operator!=(const Rect& other) const { return !(*this == other); }
+};
+
+// A set of cells stored as sorted, non-overlapping [x0, x1) spans per row.
+// Used by the compositor to track which parts of the screen are covered.
+class SpanRegion {
+public:
+    struct Span {
+        int x0, x1;
+    };
+    
+    SpanRegion() : width(0), height(0) {}
+    SpanRegion(int w, int h) { reset(w, h); }
+    
+    // Empty region over a w x h area; everything outside it is ignored
+    void reset(int w, int h);
+    void clear();
+    
+    void addRect(const Rect& r);
+    bool coversRect(const Rect& r) const;
+    
+    // Appends the parts of r not in this region, with identical spans on
+    // consecutive rows merged into taller rects
+    void subtractFrom(const Rect& r, std::vector<Rect>& out) const;
+    // Appends the parts of r inside this region, merged the same way
+    void intersectFrom(const Rect& r, std::vector<Rect>& out) const;
+    
+    const std::vector<Span>& row(int y) const { return rows[y]; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    int width, height;
+    
+    void collect(const Rect& r, std::vector<Rect>& out, bool inside) const;
+    std::vector<std::vector<Span>> rows;
+};
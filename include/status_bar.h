@@ -1,9 +1,11 @@
 #pragma once
 
 #include "buffer.h"
+#include "display_list.h"
 #include "mouse_handler.h"
 #include "colors.h"
 #include "event_system.h"
+#include "pointer_tracker.h"
 #include <string>
 #include <vector>
 #include <functional>
@@ -56,14 +58,22 @@ private:
     bool autoWidth;              // Auto-size to parent width
     bool showSeparators;
     
-    // Mouse interaction
-    bool wasLeftPressed;
+    // Mouse interaction; hover and clicks arrive from the PointerTracker
+    PointerTarget pointer;
     int hoveredSegment;
     
+    // Drawing recorded in bar-local coordinates, replayed until invalidated
+    DisplayList displayList;
+    bool displayListValid;
+    
     void generateStatusEvent(EventType type, int segmentIndex, const std::string& action);
     void calculateDimensions();
+    void handlePointer(const MouseEvent& event);
+    void setHoveredSegment(int index);
+    void placePointerTarget();
     int getSegmentAtPosition(int mx, int my) const;
     std::vector<int> calculateSegmentPositions() const;
+    void drawContents(UnicodeBuffer& buffer);
     
 public:
     StatusBar(std::shared_ptr<Window> parent, int x, int y, int width, int height = 1);
@@ -95,21 +105,22 @@ public:
     
     // Visual configuration
     void setColors(const std::string& background, const std::string& defaultText, const std::string& separator = "");
-    void setBackgroundColor(const std::string& color) { backgroundColor = color; }
-    void setDefaultTextColor(const std::string& color) { defaultTextColor = color; }
+    void setBackgroundColor(const std::string& color) { backgroundColor = color; invalidate(); }
+    void setDefaultTextColor(const std::string& color) { defaultTextColor = color; invalidate(); }
     
     // Interaction
-    void updateMouse(FastMouseHandler& mouse, int termWidth, int termHeight);
     bool contains(int mx, int my) const;
     
     // Rendering
     void draw(UnicodeBuffer& buffer);
-    void show() { visible = true; }
-    void hide() { visible = false; }
+    void show() { visible = true; placePointerTarget(); }
+    void hide() { visible = false; placePointerTarget(); }
     bool isVisible() const { return visible; }
+    // Re-record the bar on the next draw()
+    void invalidate() { displayListValid = false; }
     
     // Position management
-    void setPosition(int newX, int newY) { x = newX; y = newY; }
+    void setPosition(int newX, int newY) { x = newX; y = newY; placePointerTarget(); }
     void setSize(int newWidth, int newHeight) { width = newWidth; height = newHeight; calculateDimensions(); }
     int getX() const { return x; }
     int getY() const { return y; }
@@ -122,16 +133,16 @@ public:
     std::string getSegmentText(int index) const;
     
     // Event callbacks
-    std::function<void(const StatusBarEvent&)> onSegmentClick;
-    std::function<void(const StatusBarEvent&)> onSegmentHover;
-    std::function<void(const StatusBarEvent&)> onSegmentLeave;
-    std::function<void(const MouseEvent&)> onHover;
-    std::function<void(const MouseEvent&)> onLeave;
+    Delegate<void(const StatusBarEvent&)> onSegmentClick;
+    Delegate<void(const StatusBarEvent&)> onSegmentHover;
+    Delegate<void(const StatusBarEvent&)> onSegmentLeave;
+    Delegate<void(const MouseEvent&)> onHover;
+    Delegate<void(const MouseEvent&)> onLeave;
     
     // Event callback setters
-    void setOnSegmentClick(std::function<void(const StatusBarEvent&)> callback) { onSegmentClick = callback; }
-    void setOnSegmentHover(std::function<void(const StatusBarEvent&)> callback) { onSegmentHover = callback; }
-    void setOnSegmentLeave(std::function<void(const StatusBarEvent&)> callback) { onSegmentLeave = callback; }
-    void setOnHover(std::function<void(const MouseEvent&)> callback) { onHover = callback; }
-    void setOnLeave(std::function<void(const MouseEvent&)> callback) { onLeave = callback; }
+    void setOnSegmentClick(Delegate<void(const StatusBarEvent&)> callback) { onSegmentClick = std::move(callback); }
+    void setOnSegmentHover(Delegate<void(const StatusBarEvent&)> callback) { onSegmentHover = std::move(callback); }
+    void setOnSegmentLeave(Delegate<void(const StatusBarEvent&)> callback) { onSegmentLeave = std::move(callback); }
+    void setOnHover(Delegate<void(const MouseEvent&)> callback) { onHover = std::move(callback); }
+    void setOnLeave(Delegate<void(const MouseEvent&)> callback) { onLeave = std::move(callback); }
 };
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "delegate.h"
+#include <atomic>
+#include <cstddef>
+
+// Closures handed from any thread to one consumer thread. post() is
+// lock-free: it allocates a node and links it with one atomic exchange,
+// so producers never wait for the consumer. The first post after a drain
+// also bumps an eventfd the consumer can poll to wake up.
+class TaskQueue {
+public:
+    typedef Delegate<void()> Task;
+    
+    TaskQueue();
+    ~TaskQueue();
+    TaskQueue(const TaskQueue&) = delete;
+    TaskQueue& operator=(const TaskQueue&) = delete;
+    
+    // Any thread
+    void post(Task task);
+    
+    // Consumer thread only. Runs the tasks queued before the call; tasks
+    // they post wait for the next drain. Returns how many ran.
+    size_t drain();
+    // Becomes readable when tasks are waiting; -1 if eventfd is unavailable
+    int getWakeFd() const { return wakeFd; }
+    // Sleep until a task is posted or `timeoutMs` passes
+    void wait(int timeoutMs);
+    size_t getPendingCount() const { return pending.load(std::memory_order_relaxed); }
+
+private:
+    struct Node {
+        std::atomic<Node*> next;
+        Task task;
+    };
+    
+    // Vyukov intrusive MPSC list: producers swap themselves in at `head`,
+    // the consumer walks from `tail`. `stub` keeps the list non-empty.
+    std::atomic<Node*> head;
+    Node* tail;
+    Node stub;
+    
+    std::atomic<size_t> pending;
+    std::atomic<bool> wakePending;
+    int wakeFd;
+    
+    void push(Node* node);
+    Node* pop();
+};
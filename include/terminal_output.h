@@ -0,0 +1,115 @@
+#pragma once
+
+#include "buffer.h"
+#include "region.h"
+#include "band_encoder.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+// Keeps a model of what the terminal is currently showing and writes only
+// the cells of each new frame that differ from it. The screen is handled in
+// the frame's tiles: tiles not drawn to since the last present, or whose
+// content hash matches what was last emitted for them, are skipped without
+// comparing cells.
+//
+// In non-blocking mode a frame the descriptor cannot take at once leaves
+// its remainder in a backlog, and present() skips frames until the backlog
+// is out. The model already holds what the backlog leaves on screen, so
+// the first frame presented after it is diffed against what the terminal
+// really shows: a slow link gets fewer, larger updates, never a queue.
+class TerminalOutput {
+private:
+    struct PendingCopy {
+        Rect source;
+        int dstX, dstY;
+    };
+    
+    int width, height, stride;
+    std::unique_ptr<uint32_t, AlignedPlaneDeleter> frontGlyphs;
+    std::unique_ptr<StyleId, AlignedPlaneDeleter> frontStyles;
+    uint32_t frameId;            // Buffer whose style ids the model uses
+    bool valid;
+    
+    bool rectCopySupported;      // Terminal reported rectangular editing (DA1 28)
+    bool rectCopyEnabled;
+    std::vector<PendingCopy> pendingCopies;
+    
+    // Hash of the cells last emitted for each tile; `known` is false until
+    // a tile has been emitted or after a rect copy moved cells into it
+    struct TileState {
+        uint64_t hash;
+        bool known;
+    };
+    int tileColumns, tileRows;
+    std::vector<TileState> tiles;
+    std::vector<uint8_t> tileChanged;   // Scratch: tiles to diff this frame
+    uint64_t seenModCount;              // Frame modCount at the last present
+    bool tileSkipEnabled;
+    size_t lastDiffedTiles;
+    
+    // Frames are encoded in bands of whole tile rows, so each band owns
+    // its rows of the front model and its tiles outright
+    BandEncoder bands;
+    std::string head;            // Rect copies, written ahead of the bands
+    int outputFd;
+    size_t lastFrameBytes;
+    
+    bool nonBlocking;
+    std::string backlog;         // Encoded bytes the descriptor has not taken yet
+    size_t backlogOffset;
+    size_t deferredFrames;
+    
+    void resizeModel(int w, int h);
+    void forgetTiles(const Rect& area);
+    void collectChangedTiles(const UnicodeBuffer& frame);
+    char* emitRectCopy(char* out, const PendingCopy& copy);
+    void applyRectCopy(const PendingCopy& copy);
+    char* emitFullFrame(char* out, const UnicodeBuffer& frame, int y0, int y1);
+    char* emitChangedCells(char* out, const UnicodeBuffer& frame, int y0, int y1);
+    char* emitChangedSpan(char* out, const UnicodeBuffer& frame, int y, int x0, int x1);
+
+public:
+    TerminalOutput();
+    
+    // Sends a Primary Device Attributes query; the reply comes back on stdin
+    // and should be passed to handleDeviceAttributes()
+    void requestCapabilities();
+    void handleDeviceAttributes(const std::vector<int>& attributes);
+    bool supportsRectCopy() const { return rectCopySupported && rectCopyEnabled; }
+    void setRectCopyEnabled(bool enabled) { rectCopyEnabled = enabled; }
+    // With skipping off every tile is compared cell by cell
+    void setTileSkipEnabled(bool enabled) { tileSkipEnabled = enabled; }
+    
+    // Hint that a block already on screen moved by an offset this frame.
+    // With DECCRA support it is shifted on the terminal before diffing;
+    // otherwise the diff repaints it like any other change.
+    void copyRect(const Rect& source, int dstX, int dstY);
+    
+    // Write the cells of `frame` that differ from the terminal. Returns
+    // false if the frame was skipped because an earlier one is still going
+    // out; present a newer frame, or this one again, later.
+    bool present(const UnicodeBuffer& frame);
+    // Forget the terminal contents; the next present() repaints everything
+    void invalidate() { valid = false; }
+    // Descriptor frames are written to, stdout by default
+    void setOutputFd(int fd) { outputFd = fd; }
+    int getOutputFd() const { return outputFd; }
+    // Sets O_NONBLOCK on the descriptor. Turning it off writes out the
+    // backlog first.
+    void setNonBlocking(bool enabled);
+    bool isNonBlocking() const { return nonBlocking; }
+    // Writes what it can of the backlog without blocking; true once empty
+    bool flush();
+    bool isDraining() const { return backlogOffset < backlog.size(); }
+    // Waits up to `timeoutMs` for the descriptor to take more output
+    bool waitWritable(int timeoutMs) const;
+    size_t getBacklogBytes() const { return backlog.size() - backlogOffset; }
+    // Frames present() skipped while draining
+    size_t getDeferredFrames() const { return deferredFrames; }
+    
+    size_t getLastFrameBytes() const { return lastFrameBytes; }
+    // Tiles compared cell by cell in the last incremental present
+    size_t getLastDiffedTiles() const { return lastDiffedTiles; }
+};
@@ -4,6 +4,7 @@
 #include "mouse_handler.h"
 #include "colors.h"
 #include "event_system.h"
+#include "pointer_tracker.h"
 #include <string>
 #include <functional>
 #include <memory>
@@ -59,12 +60,15 @@ protected:
     int selectionEnd;
     bool hasSelection;
     
-    // Mouse interaction
-    bool wasLeftPressed;
+    // Mouse interaction; hover, presses and focus arrive from the PointerTracker
+    PointerTarget pointer;
     bool dragging;
     
     void generateTextEvent(EventType type, const std::string& oldText, const std::string& newText, char ch = 0);
     void calculateDimensions();
+    void handlePointer(const MouseEvent& event);
+    int textPositionAt(int mx) const;
+    void placePointerTarget();
     void moveCursor(int newPos);
     void clearSelection();
     void deleteSelection();
@@ -122,18 +126,17 @@ public:
                    const std::string& focusedBorder = "", const std::string& placeholder = "", const std::string& cursor = "");
     
     // Interaction
-    void updateMouse(FastMouseHandler& mouse, int termWidth, int termHeight);
     void handleKeyboard(char ch, int keyCode);
     bool contains(int mx, int my) const;
     
     // Rendering
     void draw(UnicodeBuffer& buffer);
-    void show() { visible = true; }
-    void hide() { visible = false; }
+    void show() { visible = true; placePointerTarget(); }
+    void hide() { visible = false; placePointerTarget(); }
     bool isVisible() const { return visible; }
     
     // Position management
-    void setPosition(int newX, int newY) { x = newX; y = newY; }
+    void setPosition(int newX, int newY) { x = newX; y = newY; placePointerTarget(); }
     void setSize(int newWidth, int newHeight) { width = newWidth; height = newHeight; calculateDimensions(); }
     int getX() const { return x; }
     int getY() const { return y; }
@@ -141,22 +144,22 @@ public:
     int getHeight() const { return height; }
     
     // Event callbacks
-    std::function<void(const TextInputEvent&)> onTextChange;
-    std::function<void(const TextInputEvent&)> onCharacterInput;
-    std::function<void(const KeyboardEvent&)> onKeyPress;
-    std::function<void(const MouseEvent&)> onFocus;
-    std::function<void(const MouseEvent&)> onBlur;
-    std::function<void(const MouseEvent&)> onHover;
-    std::function<void(const MouseEvent&)> onLeave;
-    std::function<void(const MouseEvent&)> onClick;
+    Delegate<void(const TextInputEvent&)> onTextChange;
+    Delegate<void(const TextInputEvent&)> onCharacterInput;
+    Delegate<void(const KeyboardEvent&)> onKeyPress;
+    Delegate<void(const MouseEvent&)> onFocus;
+    Delegate<void(const MouseEvent&)> onBlur;
+    Delegate<void(const MouseEvent&)> onHover;
+    Delegate<void(const MouseEvent&)> onLeave;
+    Delegate<void(const MouseEvent&)> onClick;
     
     // Event callback setters
-    void setOnTextChange(std::function<void(const TextInputEvent&)> callback) { onTextChange = callback; }
-    void setOnCharacterInput(std::function<void(const TextInputEvent&)> callback) { onCharacterInput = callback; }
-    void setOnKeyPress(std::function<void(const KeyboardEvent&)> callback) { onKeyPress = callback; }
-    void setOnFocus(std::function<void(const MouseEvent&)> callback) { onFocus = callback; }
-    void setOnBlur(std::function<void(const MouseEvent&)> callback) { onBlur = callback; }
-    void setOnHover(std::function<void(const MouseEvent&)> callback) { onHover = callback; }
-    void setOnLeave(std::function<void(const MouseEvent&)> callback) { onLeave = callback; }
-    void setOnClick(std::function<void(const MouseEvent&)> callback) { onClick = callback; }
+    void setOnTextChange(Delegate<void(const TextInputEvent&)> callback) { onTextChange = std::move(callback); }
+    void setOnCharacterInput(Delegate<void(const TextInputEvent&)> callback) { onCharacterInput = std::move(callback); }
+    void setOnKeyPress(Delegate<void(const KeyboardEvent&)> callback) { onKeyPress = std::move(callback); }
+    void setOnFocus(Delegate<void(const MouseEvent&)> callback) { onFocus = std::move(callback); }
+    void setOnBlur(Delegate<void(const MouseEvent&)> callback) { onBlur = std::move(callback); }
+    void setOnHover(Delegate<void(const MouseEvent&)> callback) { onHover = std::move(callback); }
+    void setOnLeave(Delegate<void(const MouseEvent&)> callback) { onLeave = std::move(callback); }
+    void setOnClick(Delegate<void(const MouseEvent&)> callback) { onClick = std::move(callback); }
 };
\ No newline at end of file
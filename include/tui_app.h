@@ -3,8 +3,16 @@
 #include "buffer.h"
 #include "mouse_handler.h"
 #include "window.h"
+#include "window_manager.h"
+#include "region.h"
+#include "pointer_tracker.h"
+#include "terminal_output.h"
+#include "present_thread.h"
+#include "task_queue.h"
+#include "input_recorder.h"
 #include <vector>
 #include <memory>
+#include <unordered_map>
 #include <sys/ioctl.h>
 
 enum class CursorType {
@@ -21,10 +29,43 @@ class TUIApplication {
 protected:
     FastMouseHandler mouse;
     UnicodeBuffer* buffer;
-    std::vector<std::shared_ptr<Window>> windows;
+    TerminalOutput output;
+    std::unique_ptr<PresentThread> presenter;   // Owns `output` while running
+    WindowManager windows;
     int term_width, term_height;
     int frame;
     
+    // Compositor scratch state, reused every frame
+    SpanRegion coverage;
+    SpanRegion damage;
+    std::vector<Rect> footprint;
+    std::vector<Rect> visibleRects;
+    std::vector<Rect> damagedRects;
+    
+    // Live windows bottom to top as of the last composite, for damage
+    // tracking, with each window's position in that list by Window::id
+    struct CompositedWindow {
+        uint32_t id;
+        Rect bounds;
+    };
+    std::vector<CompositedWindow> composited;
+    std::unordered_map<uint32_t, size_t> compositedIndex;
+    bool fullDamage;
+    
+    // Closures posted from other threads, run at the start of a frame
+    TaskQueue tasks;
+    
+    // Live windows are the top-level PointerTracker targets, by stacking order
+    PointerTracker& pointer;
+    std::vector<uint32_t> culledWindows;
+    
+    // Session recording, and the recording run() plays instead of reading
+    // the terminal while `replaying` is set
+    InputRecorder recorder;
+    std::unique_ptr<InputReplay> replaying;
+    bool headless;
+    int nullFd;
+    
     // Cursor state
     CursorType current_cursor_type;
     int last_mouse_x, last_mouse_y;
@@ -33,20 +74,71 @@ protected:
     void setupTerminal();
     void restoreTerminal();
     void updateTerminalSize();
+    // Hands the replay's input for this frame to the mouse handler and
+    // applies its size changes; false once the recording is used up
+    bool feedReplay();
+    // Background for the damaged cells no window covers; needs
+    // collectDamage() and compositeWindows() first
     void drawBackground();
+    // Background over the whole screen, for subclasses that redraw every
+    // frame themselves instead of compositing
+    void fillBackground();
+    void collectDamage();
+    // Mouse handling for the live windows, top first; the one starting a
+    // drag or resize is raised and takes the mouse for this frame
+    void updateWindows();
+    // Bring the pointer targets in line with window geometry and stacking;
+    // only windows that changed are re-indexed
+    void updateHitTargets();
+    // Topmost visible window at a screen cell, or null
+    Window* windowAt(int x, int y) const;
+    void compositeWindows();
     void drawStatusBar();
     void drawMouseCursor();
     CursorType determineCursorType(int mouse_x, int mouse_y);
     
 public:
-    TUIApplication();
+    // A headless application leaves the terminal alone and encodes its
+    // frames into /dev/null, for replaying recordings as benchmarks
+    explicit TUIApplication(bool headless = false);
     ~TUIApplication();
     
-    void addWindow(std::shared_ptr<Window> window);
+    WindowManager::Handle addWindow(std::shared_ptr<Window> window);
     void removeWindow(std::shared_ptr<Window> window);
+    // Stacking, showing and hiding windows by handle
+    WindowManager& getWindowManager() { return windows; }
     virtual void run();
     void quit();
     
+    // Record decoded mouse input and terminal size changes to `path`;
+    // false if the file cannot be created
+    bool startRecording(const std::string& path);
+    void stopRecording();
+    // Make run() take input and terminal size from a recording instead of
+    // the terminal, and return once the recording is used up. Real time
+    // keeps the recorded pacing; otherwise frames run back to back, each
+    // covering 16ms of the recording, so every run renders the same frames.
+    bool replay(const std::string& path, bool realTime);
+    int getFrameCount() const { return frame; }
+    
+    // Run `task` on the UI thread at the start of the next frame. The one
+    // member safe to call from any thread: widgets and windows must only be
+    // touched on the UI thread, so background threads post their updates.
+    // Never blocks; the event loop wakes early to pick the task up.
+    void post(TaskQueue::Task task) { tasks.post(std::move(task)); }
+    
+    // Diff and write frames on a separate thread so a slow terminal does
+    // not hold up input and composition; frames it cannot keep up with
+    // are skipped
+    void setPresentThreadEnabled(bool enabled);
+    // Write frames without ever blocking on the terminal: frames composed
+    // while an earlier one is still going out are skipped, and the next one
+    // sent is diffed against what the terminal really shows. Off by
+    // default: O_NONBLOCK lands on the terminal's open file description,
+    // which stdin and the parent shell share, and a process killed before
+    // turning it off leaves the shell with a non-blocking terminal.
+    void setNonBlockingOutput(bool enabled);
+    
     int getTermWidth() const { return term_width; }
     int getTermHeight() const { return term_height; }
 };
\ No newline at end of file
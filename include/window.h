@@ -2,11 +2,41 @@
 
 #include "buffer.h"
 #include "mouse_handler.h"
+#include "region.h"
+#include "event_system.h"
 #include <string>
 #include <vector>
+#include <memory>
+#include <cstdint>
 
-class Window {
+class Button;
+class Window;
+
+// Window events
+class WindowEvent : public Event {
+public:
+    std::weak_ptr<Window> window;
+    int x, y, width, height;
+    int prevX, prevY;            // WINDOW_MOVE: position before the move
+    int prevWidth, prevHeight;   // WINDOW_RESIZE: size before the resize
+    
+    WindowEvent(EventType type, std::shared_ptr<Window> window, int x, int y, int width, int height);
+};
+
+class ScrollEvent : public Event {
+public:
+    std::weak_ptr<Window> window;
+    int scrollX, scrollY;
+    int deltaX, deltaY;
+    bool vertical;               // True if the vertical offset changed
+    
+    ScrollEvent(EventType type, std::shared_ptr<Window> window, int scrollX, int scrollY,
+                int deltaX, int deltaY, bool vertical);
+};
+
+class Window : public std::enable_shared_from_this<Window> {
 public:
+    uint32_t id;                 // Owner id: names the window in hit testing and picking
     int x, y, w, h;
     std::string title;
     bool active, dragging, resizing, visible;
@@ -27,9 +57,63 @@ public:
     bool draggingHorizontalThumb = false;
     int dragThumbOffset = 0;
     
+    // Child widgets, drawn in the content area
+    std::vector<std::shared_ptr<Button>> buttons;
+    
+    // Geometry and hover state from the previous updateMouse()
+    int lastX = 0, lastY = 0, lastW = 0, lastH = 0;
+    bool wasMouseOver = false;
+    
+    // Offscreen layer holding the rasterized window and its shadow. It is
+    // repainted only when invalidated or when state that draw() reads changes.
+    struct LayerKey {
+        int w, h;
+        bool active, dragging, resizing, enableScrollbars;
+        int scrollX, scrollY, moveCount, resizeCount;
+        int contentWidth, contentHeight;
+        std::string title;
+        
+        bool operator==(const LayerKey& other) const;
+    };
+    std::unique_ptr<UnicodeBuffer> layer;
+    LayerKey layerKey;
+    bool layerDirty = true;
+    
+    // Where the content and scrollbars sit, relative to the window's
+    // top-left corner. Recomputed on the first use after a size, content,
+    // scroll or scrollbar change; draw() and the hit tests both read it.
+    struct Layout {
+        Rect content;            // Inside the border, minus any scrollbars
+        bool hasVertical, hasHorizontal;                // Line reserved for a bar
+        Rect verticalBar;        // Scrollbar column with both buttons; empty unless drawn
+        Rect horizontalBar;
+        Rect verticalThumb;      // Empty while the bar is too short to draw one
+        Rect horizontalThumb;
+        int verticalTrack, horizontalTrack;       // Cells the thumb moves along
+        int verticalMaxThumb, horizontalMaxThumb; // Thumb travel in cells
+    };
+    const Layout& getLayout() const;
+    
     Window(int x, int y, int w, int h, const std::string& title);
     
     void draw(UnicodeBuffer& buffer);
+    // Composite the cached layer into the screen, repainting it first if
+    // needed. With `visibleRects`, only those screen rects are copied and a
+    // window with nothing visible is skipped entirely.
+    void drawCached(UnicodeBuffer& screen);
+    void drawCached(UnicodeBuffer& screen, const std::vector<Rect>& visibleRects);
+    // Opaque cells covered on screen: the body plus the right and bottom shadow
+    void getFootprint(std::vector<Rect>& rects) const;
+    // View for child widgets: origin at the window's top-left corner,
+    // clipped to the area inside the border
+    BufferView view(UnicodeBuffer& buffer) const;
+    // Bounding rect of the footprint
+    Rect getBounds() const { return Rect(x, y, w + 1, h + 1); }
+    // True if the next drawCached() will re-rasterize the layer
+    bool layerNeedsRepaint() const;
+    // Call after changing content or child widgets outside the setters below
+    void invalidate() { layerDirty = true; }
+    LayerKey currentLayerKey() const;
     void updateMouse(FastMouseHandler& mouse, int termWidth, int termHeight);
     
     bool titleContains(int mx, int my) const;
@@ -52,6 +136,8 @@ public:
     void scrollDown(int lines = 1);
     void scrollLeft(int chars = 1);
     void scrollRight(int chars = 1);
+    // Positive scrolls right/down, e.g. by a MOUSE_WHEEL delta
+    void scrollBy(int dx, int dy);
     
     // Scrollbar helpers
     bool needsVerticalScrollbar() const;
@@ -65,4 +151,54 @@ public:
     bool horizontalThumbContains(int mx, int my) const;
     void handleScrollbarClick(int mx, int my);
     void handleScrollbarDrag(int mx, int my);
+    
+    // Button management
+    void addButton(std::shared_ptr<Button> button);
+    void removeButton(std::shared_ptr<Button> button);
+    void clearButtons();
+    std::shared_ptr<Button> getButtonAt(int mx, int my) const;
+    
+    // Screen coordinates of the content area, for child components
+    int getContentX() const;
+    int getContentY() const;
+    int getContentWidth() const;
+    int getContentHeight() const;
+    
+    // Event callbacks
+    Delegate<void(const WindowEvent&)> onMove;
+    Delegate<void(const WindowEvent&)> onResize;
+    Delegate<void(const WindowEvent&)> onFocus;
+    Delegate<void(const WindowEvent&)> onBlur;
+    Delegate<void(const WindowEvent&)> onClose;
+    Delegate<void(const MouseEvent&)> onMouseEnter;
+    Delegate<void(const MouseEvent&)> onMouseLeave;
+    Delegate<void(const ScrollEvent&)> onScroll;
+    
+    // Event callback setters
+    void setOnMove(Delegate<void(const WindowEvent&)> callback) { onMove = std::move(callback); }
+    void setOnResize(Delegate<void(const WindowEvent&)> callback) { onResize = std::move(callback); }
+    void setOnFocus(Delegate<void(const WindowEvent&)> callback) { onFocus = std::move(callback); }
+    void setOnBlur(Delegate<void(const WindowEvent&)> callback) { onBlur = std::move(callback); }
+    void setOnClose(Delegate<void(const WindowEvent&)> callback) { onClose = std::move(callback); }
+    void setOnMouseEnter(Delegate<void(const MouseEvent&)> callback) { onMouseEnter = std::move(callback); }
+    void setOnMouseLeave(Delegate<void(const MouseEvent&)> callback) { onMouseLeave = std::move(callback); }
+    void setOnScroll(Delegate<void(const ScrollEvent&)> callback) { onScroll = std::move(callback); }
+
+private:
+    struct LayoutKey {
+        int w, h, contentWidth, contentHeight, scrollX, scrollY;
+        bool enableScrollbars, hasContent;
+        
+        bool operator==(const LayoutKey& other) const;
+    };
+    mutable Layout layout;
+    mutable LayoutKey layoutKey;
+    mutable bool layoutValid = false;
+    
+    void computeLayout() const;
+    
+    // Require the window to be owned by a shared_ptr
+    void generateWindowEvent(EventType type);
+    void generateMouseEvents(const FastMouseHandler& mouse);
+    void generateScrollEvents(int oldScrollX, int oldScrollY);
 };
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "window.h"
+#include "region.h"
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+
+// Owns the windows and their stacking order. Windows are named by handles
+// that stay valid until the window is removed; after that the handle
+// resolves to null, even once its slot is reused. The stacking order is an
+// intrusive list threaded through the slot array, so raise() and lower()
+// relink one entry however many windows there are. A second list in the
+// same order threads through the live windows only: visible and at least
+// partly on screen. Per-frame work walks that list, so hidden and offscreen
+// windows cost nothing.
+//
+// Visibility and geometry are plain Window fields, so the manager learns of
+// changes in two ways: refreshLive() re-checks the live windows once per
+// frame, and refresh() re-checks one window changed while it was not live
+// (shown again, moved back on screen). show() and hide() do both steps.
+class WindowManager {
+public:
+    typedef uint32_t Handle;     // 0 is never a valid handle
+    
+    WindowManager();
+    WindowManager(const WindowManager&) = delete;
+    WindowManager& operator=(const WindowManager&) = delete;
+    
+    // Added on top
+    Handle add(std::shared_ptr<Window> window);
+    void remove(Handle handle);
+    // Null for 0 or the handle of a removed window
+    Window* get(Handle handle) const;
+    // Handle of the managed window with this Window::id, or 0
+    Handle find(uint32_t windowId) const;
+    size_t size() const { return count; }
+    
+    void raise(Handle handle);
+    void lower(Handle handle);
+    
+    void show(Handle handle);
+    void hide(Handle handle);
+    void refresh(Handle handle);
+    void refreshLive();
+    // Windows entirely outside the screen are culled; re-checks every
+    // window when the size changes
+    void setScreen(int w, int h);
+    
+    // Appends the Window::ids of windows that dropped out of the live list
+    // since the last call, removed windows excepted
+    void takeCulled(std::vector<uint32_t>& ids);
+    
+    // Walk bottom to top or top to bottom, all windows or the live ones:
+    //   for (Handle h = wm.bottomLive(); h; h = wm.liveAbove(h)) ...
+    // Raising or lowering the current window while walking skips or
+    // repeats windows; stop the walk after doing so.
+    Handle bottom() const { return handleOf(lists[ALL].bottom); }
+    Handle top() const { return handleOf(lists[ALL].top); }
+    Handle above(Handle handle) const { return step(handle, ALL, true); }
+    Handle below(Handle handle) const { return step(handle, ALL, false); }
+    Handle bottomLive() const { return handleOf(lists[LIVE].bottom); }
+    Handle topLive() const { return handleOf(lists[LIVE].top); }
+    Handle liveAbove(Handle handle) const { return step(handle, LIVE, true); }
+    Handle liveBelow(Handle handle) const { return step(handle, LIVE, false); }
+    bool isLive(Handle handle) const;
+    size_t liveCount() const { return live; }
+
+private:
+    enum { ALL = 0, LIVE = 1 };
+    enum : uint32_t { NIL = 0xffffffffu };
+    // Handles are the slot index plus one in the low bits and the slot's
+    // generation, bumped on every remove, in the high bits
+    enum : uint32_t { SLOT_BITS = 22, SLOT_MASK = (1u << SLOT_BITS) - 1 };
+    
+    struct Link {
+        uint32_t below, above;
+    };
+    struct List {
+        uint32_t bottom, top;
+    };
+    struct Slot {
+        std::shared_ptr<Window> window;
+        uint32_t generation;
+        int64_t z;               // Stacking key; higher is on top
+        bool live;
+        Link links[2];
+    };
+    
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<uint32_t, Handle> byId;
+    List lists[2];
+    int64_t topZ, bottomZ;
+    size_t count, live;
+    Rect screen;
+    std::vector<uint32_t> culled;
+    
+    Handle handleOf(uint32_t slot) const;
+    // Slot index for a current handle, or NIL
+    uint32_t slotOf(Handle handle) const;
+    Handle step(Handle handle, int list, bool up) const;
+    
+    void unlink(int list, uint32_t slot);
+    // Links `slot` directly above `below`, or at the bottom for NIL
+    void linkAbove(int list, uint32_t slot, uint32_t below);
+    // Moves a window in or out of the live list to match its state
+    void evaluate(uint32_t slot);
+};
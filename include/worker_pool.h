@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+// Small process-wide pool for splitting frame work across cores. The caller
+// of parallelFor() runs tasks too, so with no workers everything simply runs
+// on the calling thread.
+class WorkerPool {
+private:
+    std::vector<std::thread> workers;
+    
+    std::mutex jobMutex;         // One parallelFor() at a time
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t generation;
+    bool stopping;
+    
+    // Current job, read by workers under mutex together with generation
+    const std::function<void(size_t)>* task;
+    size_t taskCount;
+    // Low 32 bits of the job's generation above the next task index. A
+    // claim only succeeds while the generation matches, so a worker still
+    // looping over a finished job can neither run its task again nor take
+    // an index of the next job.
+    std::atomic<uint64_t> nextTask;
+    std::atomic<size_t> remaining;
+    
+    WorkerPool();
+    void workerLoop();
+    void runTasks(uint64_t job, const std::function<void(size_t)>& fn, size_t count);
+
+public:
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    
+    static WorkerPool& getInstance();
+    
+    // Threads besides the caller: hardware threads minus one, at most 7
+    size_t getWorkerCount() const { return workers.size(); }
+    
+    // Runs fn(0) .. fn(count - 1) across the pool and returns when all
+    // have finished
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+};
@@ -1,14 +1,35 @@
 #include "../include/asm_optimized.h"
 #include <cstring>
+#include <cstdlib>
+#include <ctime>
 #include <immintrin.h>
 #include <algorithm>
 
+// AVX2 and SSSE3 paths are compiled per function with a target attribute
+// and chosen at run time by has_avx2() / has_ssse3(), so the library itself
+// is built for the baseline ISA and still runs on CPUs without them. SSE2 is
+// part of the x86-64 baseline and stays a compile-time choice.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(TUI_NO_AVX2)
+#define TUI_AVX2_DISPATCH 1
+#define TUI_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TUI_AVX2_DISPATCH 0
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TUI_SSSE3_DISPATCH 1
+#define TUI_TARGET_SSSE3 __attribute__((target("ssse3")))
+#else
+#define TUI_SSSE3_DISPATCH 0
+#endif
+
 namespace ASMOptimized {
 
 // Simplified SIMD pattern fill for demonstration
 size_t fast_render_buffer_optimized(char* output_buffer, const char** cells, const char** colors, 
                                    size_t width, size_t height, size_t max_output_size) {
-    #ifdef __AVX2__
+    if (!has_avx2()) return 0;
+    
     // Simplified version that just demonstrates SIMD capability
     // Real implementation would need more sophisticated memory handling
     
@@ -35,35 +56,36 @@ size_t fast_render_buffer_optimized(char* output_buffer, const char** cells, con
     
     output_buffer[pos] = '\0';
     return pos;
-    #else
-    return 0;
-    #endif
 }
 
+#if TUI_AVX2_DISPATCH
+static TUI_TARGET_AVX2 void pattern_fill_avx2(void* dest, uint64_t pattern, size_t count) {
+    __m256i pattern_vec = _mm256_set1_epi64x(pattern);
+    uint8_t* ptr = (uint8_t*)dest;
+    
+    // Process 32-byte chunks
+    size_t chunks = count / 32;
+    for (size_t i = 0; i < chunks; i++) {
+        _mm256_storeu_si256((__m256i*)(ptr + i * 32), pattern_vec);
+    }
+    
+    // Handle remaining bytes
+    size_t remaining = count % 32;
+    if (remaining > 0) {
+        memset(ptr + chunks * 32, pattern & 0xFF, remaining);
+    }
+}
+#endif
+
 // Vectorized memory pattern operations for fast fills
 void fast_pattern_fill_avx2(void* dest, uint64_t pattern, size_t count) {
-    #ifdef __AVX2__
-    if (count >= 32) {
-        __m256i pattern_vec = _mm256_set1_epi64x(pattern);
-        uint8_t* ptr = (uint8_t*)dest;
-        
-        // Process 32-byte chunks
-        size_t chunks = count / 32;
-        for (size_t i = 0; i < chunks; i++) {
-            _mm256_storeu_si256((__m256i*)(ptr + i * 32), pattern_vec);
-        }
-        
-        // Handle remaining bytes
-        size_t remaining = count % 32;
-        if (remaining > 0) {
-            memset(ptr + chunks * 32, pattern & 0xFF, remaining);
-        }
-    } else {
-        memset(dest, pattern & 0xFF, count);
+    #if TUI_AVX2_DISPATCH
+    if (count >= 32 && has_avx2()) {
+        pattern_fill_avx2(dest, pattern, count);
+        return;
     }
-    #else
-    memset(dest, pattern & 0xFF, count);
     #endif
+    memset(dest, pattern & 0xFF, count);
 }
 
 // SIMD-accelerated memory copy operations
@@ -103,17 +125,31 @@ bool has_sse2() {
     #endif
 }
 
+// AVX and AVX2 are probed once with CPUID, including the OS check that the
+// upper register halves are saved
 bool has_avx() {
-    #ifdef __AVX__
-    return true;
+    #if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx") != 0);
+    return supported;
     #else
     return false;
     #endif
 }
 
+// False when the AVX2 paths are compiled out (TUI_NO_AVX2)
 bool has_avx2() {
-    #ifdef __AVX2__
-    return true;
+    #if TUI_AVX2_DISPATCH
+    static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0);
+    return supported;
+    #else
+    return false;
+    #endif
+}
+
+bool has_ssse3() {
+    #if TUI_SSSE3_DISPATCH
+    static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("ssse3") != 0);
+    return supported;
     #else
     return false;
     #endif
@@ -130,15 +166,98 @@ uint64_t get_cpu_cycles() {
     #endif
 }
 
+uint64_t monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#ifdef __x86_64__
+static void cpuid(uint32_t leaf, uint32_t& eax, uint32_t& ebx, uint32_t& ecx, uint32_t& edx) {
+    __asm__ volatile ("cpuid"
+                     : "=a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx)
+                     : "a" (leaf), "c" (0));
+}
+#endif
+
+static TimingInfo calibrate_timing() {
+    TimingInfo info = {false, false, false, 1.0};
+    
+    #ifdef __x86_64__
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(0x80000000, eax, ebx, ecx, edx);
+    uint32_t max_extended = eax;
+    
+    if (max_extended >= 0x80000001) {
+        cpuid(0x80000001, eax, ebx, ecx, edx);
+        info.has_rdtscp = (edx >> 27) & 1;
+    }
+    if (max_extended >= 0x80000007) {
+        cpuid(0x80000007, eax, ebx, ecx, edx);
+        info.invariant_tsc = (edx >> 8) & 1;
+    }
+    
+    // A TSC that changes rate with P-states can't be converted to time
+    if (info.invariant_tsc) {
+        uint64_t ns_start = monotonic_ns();
+        uint64_t tsc_start = get_cpu_cycles();
+        while (monotonic_ns() - ns_start < 10000000ull) {
+            // Spin ~10ms so clock_gettime granularity is negligible
+        }
+        uint64_t tsc_end = get_cpu_cycles();
+        uint64_t ns_end = monotonic_ns();
+        
+        if (tsc_end > tsc_start && ns_end > ns_start) {
+            info.ticks_per_ns = (double)(tsc_end - tsc_start) / (double)(ns_end - ns_start);
+            info.using_tsc = true;
+        }
+    }
+    #endif
+    
+    return info;
+}
+
+const TimingInfo& timing_info() {
+    static const TimingInfo info = calibrate_timing();
+    return info;
+}
+
+uint64_t read_ticks_begin() {
+    #ifdef __x86_64__
+    if (timing_info().using_tsc) {
+        uint32_t lo, hi;
+        __asm__ volatile ("lfence\n\trdtsc" : "=a" (lo), "=d" (hi) :: "memory");
+        return ((uint64_t)hi << 32) | lo;
+    }
+    #endif
+    return monotonic_ns();
+}
+
+uint64_t read_ticks_end() {
+    #ifdef __x86_64__
+    const TimingInfo& info = timing_info();
+    if (info.using_tsc) {
+        uint32_t lo, hi;
+        if (info.has_rdtscp) {
+            __asm__ volatile ("rdtscp\n\tlfence" : "=a" (lo), "=d" (hi) :: "rcx", "memory");
+        } else {
+            __asm__ volatile ("lfence\n\trdtsc\n\tlfence" : "=a" (lo), "=d" (hi) :: "memory");
+        }
+        return ((uint64_t)hi << 32) | lo;
+    }
+    #endif
+    return monotonic_ns();
+}
+
+double ticks_to_ns(uint64_t ticks) {
+    return (double)ticks / timing_info().ticks_per_ns;
+}
+
 // SIMD-optimized buffer rendering with vectorized color comparison
 size_t fast_render_buffer(const RenderContext& ctx) {
-    #ifdef __AVX2__
-    if (ctx.width * ctx.height > 1000) {  // Only optimize for larger buffers
+    if (has_avx2() && ctx.width * ctx.height > 1000) {  // Only optimize for larger buffers
         size_t optimized_operations = 0;
         
-        // AVX2 can process 32 bytes at once for color comparison
-        const __m256i reset_color = _mm256_set1_epi8('\033');  // Start of ANSI sequence
-        
         for (size_t y = 0; y < ctx.height; y++) {
             size_t x = 0;
             // Process 32 characters at a time with AVX2
@@ -150,7 +269,6 @@ size_t fast_render_buffer(const RenderContext& ctx) {
         }
         return optimized_operations;
     }
-    #endif
     return 0;  // Fallback to standard implementation
 }
 
@@ -219,6 +337,140 @@ MouseParseResult fast_parse_mouse_input(const char* buffer, size_t length) {
     return result;
 }
 
+// SGR payload after "\033[<": up to 4 digits per field, two ';' and the
+// terminator always fit in one 16-byte vector
+static const size_t SGR_MAX_PAYLOAD = 16;
+
+// Shuffle masks that right-align the three fields into 4-byte slots,
+// indexed by field lengths (1-4 each). Leading lanes are zeroed (0x80).
+struct SGRShuffleTable {
+    uint8_t masks[64][16];
+    
+    SGRShuffleTable() {
+        for (int l0 = 1; l0 <= 4; l0++) {
+            for (int l1 = 1; l1 <= 4; l1++) {
+                for (int l2 = 1; l2 <= 4; l2++) {
+                    uint8_t* mask = masks[(l0 - 1) * 16 + (l1 - 1) * 4 + (l2 - 1)];
+                    const int lengths[3] = {l0, l1, l2};
+                    const int starts[3] = {0, l0 + 1, l0 + l1 + 2};
+                    
+                    memset(mask, 0x80, 16);
+                    for (int slot = 0; slot < 3; slot++) {
+                        int pad = 4 - lengths[slot];
+                        for (int i = 0; i < lengths[slot]; i++) {
+                            mask[slot * 4 + pad + i] = (uint8_t)(starts[slot] + i);
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+static const SGRShuffleTable sgr_shuffle_table;
+
+#if TUI_SSSE3_DISPATCH
+static TUI_TARGET_SSSE3 int decode_sgr_payload_ssse3(const char* payload, size_t avail, SGRMouseEvent& event) {
+    __m128i chunk;
+    uint32_t valid;
+    if (avail >= SGR_MAX_PAYLOAD) {
+        chunk = _mm_loadu_si128((const __m128i*)payload);
+        valid = 0xFFFF;
+    } else {
+        // Never read past the caller's buffer; zero padding matches no class
+        alignas(16) char padded[16] = {0};
+        memcpy(padded, payload, avail);
+        chunk = _mm_load_si128((const __m128i*)padded);
+        valid = (1u << avail) - 1;
+    }
+    
+    // Classify every byte at once
+    __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)),
+                                     _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1)));
+    __m128i is_term = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('M')),
+                                   _mm_cmpeq_epi8(chunk, _mm_set1_epi8('m')));
+    uint32_t digits = _mm_movemask_epi8(is_digit) & valid;
+    uint32_t semis = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(';'))) & valid;
+    uint32_t terms = _mm_movemask_epi8(is_term) & valid;
+    
+    if (terms == 0) {
+        // Cut off: wait for the rest only if what arrived is a valid start,
+        // i.e. no empty field, no run of 5 digits and at most two ';'
+        if (avail >= SGR_MAX_PAYLOAD || (digits | semis) != valid) return -1;
+        if ((semis & 1) || (semis & (semis >> 1))) return -1;
+        if (digits & (digits >> 1) & (digits >> 2) & (digits >> 3) & (digits >> 4)) return -1;
+        if (__builtin_popcount(semis) > 2) return -1;
+        return 0;
+    }
+    
+    uint32_t t = __builtin_ctz(terms);
+    uint32_t body = (1u << t) - 1;
+    if (((digits | semis) & body) != body) return -1;
+    if (__builtin_popcount(semis & body) != 2) return -1;
+    
+    uint32_t s1 = __builtin_ctz(semis);
+    uint32_t s2 = __builtin_ctz(semis & (semis - 1));
+    int l0 = (int)s1;
+    int l1 = (int)(s2 - s1 - 1);
+    int l2 = (int)(t - s2 - 1);
+    if (l0 < 1 || l0 > 4 || l1 < 1 || l1 > 4 || l2 < 1 || l2 > 4) return -1;
+    
+    // Right-align each field into a 4-digit slot, then reduce:
+    // pairs (d*10 + d) with maddubs, then slots (hi*100 + lo) with madd
+    const __m128i mask = _mm_loadu_si128((const __m128i*)
+        sgr_shuffle_table.masks[(l0 - 1) * 16 + (l1 - 1) * 4 + (l2 - 1)]);
+    __m128i values = _mm_shuffle_epi8(_mm_sub_epi8(chunk, _mm_set1_epi8('0')), mask);
+    __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi16(0x010A));
+    __m128i slots = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00010064));
+    
+    event.button = _mm_cvtsi128_si32(slots);
+    event.x = _mm_cvtsi128_si32(_mm_srli_si128(slots, 4));
+    event.y = _mm_cvtsi128_si32(_mm_srli_si128(slots, 8));
+    event.press = payload[t] == 'M';
+    return (int)(3 + t + 1);
+}
+#endif
+
+// Scalar path with identical validation rules
+static int decode_sgr_payload_scalar(const char* payload, size_t avail, SGRMouseEvent& event) {
+    int fields[3] = {0, 0, 0};
+    int field = 0, digitCount = 0;
+    size_t limit = std::min(avail, SGR_MAX_PAYLOAD);
+    
+    for (size_t i = 0; i < limit; i++) {
+        char ch = payload[i];
+        if (ch >= '0' && ch <= '9') {
+            if (++digitCount > 4) return -1;
+            fields[field] = fields[field] * 10 + (ch - '0');
+        } else if (ch == ';') {
+            if (digitCount == 0 || field == 2) return -1;
+            field++;
+            digitCount = 0;
+        } else if (ch == 'M' || ch == 'm') {
+            if (digitCount == 0 || field != 2) return -1;
+            event.button = fields[0];
+            event.x = fields[1];
+            event.y = fields[2];
+            event.press = ch == 'M';
+            return (int)(3 + i + 1);
+        } else {
+            return -1;
+        }
+    }
+    return avail < SGR_MAX_PAYLOAD ? 0 : -1;
+}
+
+int fast_decode_sgr_mouse(const char* buffer, size_t length, SGRMouseEvent& event) {
+    static const char prefix[3] = {'\033', '[', '<'};
+    if (memcmp(buffer, prefix, std::min(length, (size_t)3)) != 0) return -1;
+    if (length <= 3) return 0;
+    
+    #if TUI_SSSE3_DISPATCH
+    if (has_ssse3()) return decode_sgr_payload_ssse3(buffer + 3, length - 3, event);
+    #endif
+    return decode_sgr_payload_scalar(buffer + 3, length - 3, event);
+}
+
 // Fast memory operations using SIMD
 void fast_memset_pattern(void* dest, int pattern, size_t count) {
     #ifdef __SSE2__
@@ -252,83 +504,487 @@ void fast_memset_pattern(void* dest, int pattern, size_t count) {
     #endif
 }
 
-// SIMD-optimized horizontal line drawing
-void fast_draw_horizontal_line(char** cells, char** colors, 
-                              int x, int y, int width, 
-                              const char* character, const char* color) {
+// Spans larger than this are written with non-temporal stores: a cleared
+// full-screen buffer is not read again until render(), so there is no point
+// evicting the rest of the working set to hold it in cache.
+static const size_t NON_TEMPORAL_THRESHOLD = 256 * 1024;
+
+// The AVX2 span fills stop short of the last vector's worth of cells and
+// return how far they got; the SSE2 and scalar code finishes the span
+#if TUI_AVX2_DISPATCH
+static TUI_TARGET_AVX2 size_t fill_u32_span_avx2(uint32_t* dest, uint32_t value, size_t count, bool stream) {
+    size_t i = 0;
+    // Scalar head until the destination is 32-byte aligned
+    while (i < count && ((uintptr_t)(dest + i) & 31) != 0) {
+        dest[i++] = value;
+    }
+    const __m256i value_vec = _mm256_set1_epi32((int)value);
+    if (stream) {
+        for (; i + 8 <= count; i += 8) {
+            _mm256_stream_si256((__m256i*)(dest + i), value_vec);
+        }
+    } else {
+        for (; i + 8 <= count; i += 8) {
+            _mm256_store_si256((__m256i*)(dest + i), value_vec);
+        }
+    }
+    return i;
+}
+
+static TUI_TARGET_AVX2 size_t fill_u16_span_avx2(uint16_t* dest, uint16_t value, size_t count, bool stream) {
+    size_t i = 0;
+    while (i < count && ((uintptr_t)(dest + i) & 31) != 0) {
+        dest[i++] = value;
+    }
+    const __m256i value_vec = _mm256_set1_epi16((short)value);
+    if (stream) {
+        for (; i + 16 <= count; i += 16) {
+            _mm256_stream_si256((__m256i*)(dest + i), value_vec);
+        }
+    } else {
+        for (; i + 16 <= count; i += 16) {
+            _mm256_store_si256((__m256i*)(dest + i), value_vec);
+        }
+    }
+    return i;
+}
+#endif
+
+static void fill_u32_span(uint32_t* dest, uint32_t value, size_t count, bool stream, bool avx2) {
+    size_t i = 0;
+    #if TUI_AVX2_DISPATCH
+    if (avx2) i = fill_u32_span_avx2(dest, value, count, stream);
+    #else
+    (void)avx2;
+    #endif
+    #ifdef __SSE2__
+    while (i < count && ((uintptr_t)(dest + i) & 15) != 0) {
+        dest[i++] = value;
+    }
+    const __m128i value_vec = _mm_set1_epi32((int)value);
+    if (stream) {
+        for (; i + 4 <= count; i += 4) {
+            _mm_stream_si128((__m128i*)(dest + i), value_vec);
+        }
+    } else {
+        for (; i + 4 <= count; i += 4) {
+            _mm_store_si128((__m128i*)(dest + i), value_vec);
+        }
+    }
+    #else
+    (void)stream;
+    #endif
+    
+    // Handle remainder
+    for (; i < count; i++) {
+        dest[i] = value;
+    }
+}
+
+static void fill_u16_span(uint16_t* dest, uint16_t value, size_t count, bool stream, bool avx2) {
+    size_t i = 0;
+    #if TUI_AVX2_DISPATCH
+    if (avx2) i = fill_u16_span_avx2(dest, value, count, stream);
+    #else
+    (void)avx2;
+    #endif
+    #ifdef __SSE2__
+    while (i < count && ((uintptr_t)(dest + i) & 15) != 0) {
+        dest[i++] = value;
+    }
+    const __m128i value_vec = _mm_set1_epi16((short)value);
+    if (stream) {
+        for (; i + 8 <= count; i += 8) {
+            _mm_stream_si128((__m128i*)(dest + i), value_vec);
+        }
+    } else {
+        for (; i + 8 <= count; i += 8) {
+            _mm_store_si128((__m128i*)(dest + i), value_vec);
+        }
+    }
+    #else
+    (void)stream;
+    #endif
+    
+    for (; i < count; i++) {
+        dest[i] = value;
+    }
+}
+
+// Clear both cell planes of a UnicodeBuffer in one pass
+void fast_buffer_clear_optimized(uint32_t* glyphs, uint16_t* styles, size_t count,
+                                 uint32_t glyph, uint16_t style) {
+    bool stream = count * (sizeof(uint32_t) + sizeof(uint16_t)) >= NON_TEMPORAL_THRESHOLD;
+    
+    bool avx2 = has_avx2();
+    fill_u32_span(glyphs, glyph, count, stream, avx2);
+    fill_u16_span(styles, style, count, stream, avx2);
+    
     #ifdef __SSE2__
-    if (width >= 16) {
-        // Use SIMD for bulk character assignment
-        __m128i char_vec = _mm_set1_epi8(character[0]);
+    if (stream) {
+        // Streaming stores are weakly ordered; fence before anyone reads the planes
+        _mm_sfence();
+    }
+    #endif
+}
+
+// Fill a w x h rectangle; glyphs/styles point at its top-left cell
+void fast_rect_fill(uint32_t* glyphs, uint16_t* styles, size_t stride,
+                    size_t w, size_t h, uint32_t glyph, uint16_t style) {
+    bool avx2 = has_avx2();
+    for (size_t row = 0; row < h; row++) {
+        fill_u32_span(glyphs + row * stride, glyph, w, false, avx2);
+        fill_u16_span(styles + row * stride, style, w, false, avx2);
+    }
+}
+
+// Glyph rows are plain copies; style rows go through the id translation
+// table unless the source and destination share a style table
+void fast_blit_cells(uint32_t* dst_glyphs, uint16_t* dst_styles, size_t dst_stride,
+                     const uint32_t* src_glyphs, const uint16_t* src_styles, size_t src_stride,
+                     size_t w, size_t h, const uint16_t* style_map) {
+    for (size_t row = 0; row < h; row++) {
+        uint32_t* glyph_out = dst_glyphs + row * dst_stride;
+        uint16_t* style_out = dst_styles + row * dst_stride;
+        const uint32_t* glyph_in = src_glyphs + row * src_stride;
+        const uint16_t* style_in = src_styles + row * src_stride;
         
-        // Process 16 characters at a time
-        for (int i = 0; i < width - 15; i += 16) {
-            // This would write to aligned memory in real implementation
-            for (int j = 0; j < 16 && i + j < width; j++) {
-                if (cells[y]) cells[y][x + i + j] = character[0];
-                // Color assignment would also be vectorized
-            }
+        memcpy(glyph_out, glyph_in, w * sizeof(uint32_t));
+        
+        if (!style_map) {
+            memcpy(style_out, style_in, w * sizeof(uint16_t));
+            continue;
         }
         
-        // Handle remainder
-        for (int i = (width / 16) * 16; i < width; i++) {
-            if (cells[y]) cells[y][x + i] = character[0];
+        size_t i = 0;
+        for (; i + 4 <= w; i += 4) {
+            style_out[i] = style_map[style_in[i]];
+            style_out[i + 1] = style_map[style_in[i + 1]];
+            style_out[i + 2] = style_map[style_in[i + 2]];
+            style_out[i + 3] = style_map[style_in[i + 3]];
+        }
+        for (; i < w; i++) {
+            style_out[i] = style_map[style_in[i]];
+        }
+    }
+}
+
+// Broadcast one pre-encoded cell across a row
+void fast_draw_horizontal_line(uint32_t* glyphs, uint16_t* styles, size_t length,
+                               uint32_t glyph, uint16_t style) {
+    bool avx2 = has_avx2();
+    fill_u32_span(glyphs, glyph, length, false, avx2);
+    fill_u16_span(styles, style, length, false, avx2);
+}
+
+// Vertical lines can't use contiguous vector stores, so issue unrolled
+// strided stores instead of a bounds-checked call per cell
+void fast_draw_vertical_line(uint32_t* glyphs, uint16_t* styles, size_t stride,
+                             size_t length, uint32_t glyph, uint16_t style) {
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        glyphs[0] = glyph;
+        glyphs[stride] = glyph;
+        glyphs[stride * 2] = glyph;
+        glyphs[stride * 3] = glyph;
+        styles[0] = style;
+        styles[stride] = style;
+        styles[stride * 2] = style;
+        styles[stride * 3] = style;
+        glyphs += stride * 4;
+        styles += stride * 4;
+    }
+    for (; i < length; i++) {
+        *glyphs = glyph;
+        *styles = style;
+        glyphs += stride;
+        styles += stride;
+    }
+}
+
+// Length-checked equality for short escape sequences (color codes)
+bool fast_string_equal(const char* a, size_t a_len, const char* b, size_t b_len) {
+    if (a_len != b_len) return false;
+    if (a == b) return true;
+    
+    size_t i = 0;
+    #ifdef __SSE2__
+    for (; i + 16 <= a_len; i += 16) {
+        __m128i chunk1 = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i chunk2 = _mm_loadu_si128((const __m128i*)(b + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(chunk1, chunk2)) != 0xFFFF) {
+            return false;
+        }
+    }
+    #endif
+    
+    return memcmp(a + i, b + i, a_len - i) == 0;
+}
+
+// The AVX2 scans below advance `i` over whole vectors and return true once
+// they find the answer; otherwise the SSE2 and scalar code carries on from `i`
+#if TUI_AVX2_DISPATCH
+static TUI_TARGET_AVX2 bool style_run_end_avx2(const uint16_t* styles, size_t count, size_t& i) {
+    const __m256i first_vec = _mm256_set1_epi16((short)styles[0]);
+    for (; i + 16 <= count; i += 16) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)(styles + i));
+        uint32_t equal = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi16(chunk, first_vec));
+        if (equal != 0xFFFFFFFF) {
+            i += __builtin_ctz(~equal) >> 1; // Two mask bits per 16-bit lane
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+// Length of the run of equal styles starting at styles[0]
+size_t fast_style_run_length(const uint16_t* styles, size_t count) {
+    if (count == 0) return 0;
+    
+    const uint16_t first = styles[0];
+    size_t i = 1;
+    
+    #if TUI_AVX2_DISPATCH
+    if (has_avx2() && style_run_end_avx2(styles, count, i)) return i;
+    #endif
+    #ifdef __SSE2__
+    const __m128i first_vec = _mm_set1_epi16((short)first);
+    for (; i + 8 <= count; i += 8) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(styles + i));
+        uint32_t equal = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi16(chunk, first_vec));
+        if (equal != 0xFFFF) {
+            return i + (__builtin_ctz(~equal) >> 1);
         }
-        return;
     }
     #endif
     
-    // Fallback for smaller lines or non-SIMD
-    for (int i = 0; i < width; i++) {
-        if (cells[y]) cells[y][x + i] = character[0];
+    while (i < count && styles[i] == first) {
+        i++;
     }
+    return i;
 }
 
-// SIMD-optimized vertical line drawing  
-void fast_draw_vertical_line(char** cells, char** colors,
-                            int x, int y, int height,
-                            const char* character, const char* color) {
-    // Vertical operations are harder to vectorize due to memory layout
-    // But we can still optimize with prefetching and cache-friendly access
-    for (int i = 0; i < height; i++) {
-        if (cells[y + i]) {
-            cells[y + i][x] = character[0];
-            // Would also handle color assignment
+// A cell matches when both its glyph and its style match. The vector paths
+// build an 8-bit equality mask and look for the first bit in the wanted state.
+#if TUI_AVX2_DISPATCH
+static TUI_TARGET_AVX2 bool find_cell_state_avx2(const uint32_t* glyphs_a, const uint16_t* styles_a,
+                                                 const uint32_t* glyphs_b, const uint16_t* styles_b,
+                                                 size_t count, bool want_equal, size_t& i) {
+    for (; i + 8 <= count; i += 8) {
+        __m256i ga = _mm256_loadu_si256((const __m256i*)(glyphs_a + i));
+        __m256i gb = _mm256_loadu_si256((const __m256i*)(glyphs_b + i));
+        __m128i sa = _mm_loadu_si128((const __m128i*)(styles_a + i));
+        __m128i sb = _mm_loadu_si128((const __m128i*)(styles_b + i));
+        
+        uint32_t glyph_eq = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(ga, gb)));
+        __m128i style_cmp = _mm_cmpeq_epi16(sa, sb);
+        uint32_t style_eq = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(style_cmp, style_cmp)) & 0xFF;
+        
+        uint32_t mask = want_equal ? (glyph_eq & style_eq) : (~(glyph_eq & style_eq) & 0xFF);
+        if (mask) {
+            i += __builtin_ctz(mask);
+            return true;
         }
     }
+    return false;
 }
+#endif
 
-// SIMD-optimized buffer clearing with AVX2
-void fast_clear_buffer(char** cells, char** colors, 
-                      size_t width, size_t height) {
-    #ifdef __AVX2__
-    const __m256i space_vec = _mm256_set1_epi8(' ');
+static size_t find_cell_state(const uint32_t* glyphs_a, const uint16_t* styles_a,
+                              const uint32_t* glyphs_b, const uint16_t* styles_b,
+                              size_t count, bool want_equal) {
+    size_t i = 0;
     
-    for (size_t y = 0; y < height; y++) {
-        if (!cells[y]) continue;
+    #if TUI_AVX2_DISPATCH
+    if (has_avx2() && find_cell_state_avx2(glyphs_a, styles_a, glyphs_b, styles_b, count, want_equal, i)) {
+        return i;
+    }
+    #endif
+    #ifdef __SSE2__
+    for (; i + 4 <= count; i += 4) {
+        __m128i ga = _mm_loadu_si128((const __m128i*)(glyphs_a + i));
+        __m128i gb = _mm_loadu_si128((const __m128i*)(glyphs_b + i));
+        __m128i sa = _mm_loadl_epi64((const __m128i*)(styles_a + i));
+        __m128i sb = _mm_loadl_epi64((const __m128i*)(styles_b + i));
         
-        size_t x = 0;
-        // Clear 32 characters at a time with AVX2
-        for (; x + 32 <= width; x += 32) {
-            // In real implementation, this would store to aligned memory
-            for (size_t j = 0; j < 32; j++) {
-                cells[y][x + j] = ' ';
-            }
+        uint32_t glyph_eq = (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(ga, gb)));
+        __m128i style_cmp = _mm_cmpeq_epi16(sa, sb);
+        uint32_t style_eq = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(style_cmp, style_cmp)) & 0xF;
+        
+        uint32_t mask = want_equal ? (glyph_eq & style_eq) : (~(glyph_eq & style_eq) & 0xF);
+        if (mask) {
+            return i + __builtin_ctz(mask);
         }
+    }
+    #endif
+    
+    for (; i < count; i++) {
+        bool equal = glyphs_a[i] == glyphs_b[i] && styles_a[i] == styles_b[i];
+        if (equal == want_equal) return i;
+    }
+    return count;
+}
+
+size_t fast_cells_find_diff(const uint32_t* glyphs_a, const uint16_t* styles_a,
+                            const uint32_t* glyphs_b, const uint16_t* styles_b, size_t count) {
+    return find_cell_state(glyphs_a, styles_a, glyphs_b, styles_b, count, false);
+}
+
+size_t fast_cells_find_equal(const uint32_t* glyphs_a, const uint16_t* styles_a,
+                             const uint32_t* glyphs_b, const uint16_t* styles_b, size_t count) {
+    return find_cell_state(glyphs_a, styles_a, glyphs_b, styles_b, count, true);
+}
+
+static const uint64_t HASH_PRIME_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t HASH_PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint32_t HASH_GLYPH_KEY = 0x85EBCA6Bu;
+static const uint32_t HASH_STYLE_KEY = 0xC2B2AE35u;
+
+static inline uint64_t rotl64(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Lane step shared by both paths: each of four 64-bit lanes takes two
+// adjacent cells, adds the products of their keyed glyph and style words
+// plus the raw words, then rotates so block order matters
+static inline uint64_t hash_lane(uint64_t acc, const uint32_t* glyphs, const uint16_t* styles) {
+    uint64_t sum = (uint64_t)(glyphs[0] ^ HASH_GLYPH_KEY) * (styles[0] ^ HASH_STYLE_KEY) +
+                   (uint64_t)(glyphs[1] ^ HASH_GLYPH_KEY) * (styles[1] ^ HASH_STYLE_KEY) +
+                   ((glyphs[0] | (uint64_t)glyphs[1] << 32) + (styles[0] | (uint64_t)styles[1] << 32));
+    return rotl64(acc + sum, 17);
+}
+
+#if TUI_AVX2_DISPATCH
+// 8 cells per step: glyphs as eight 32-bit lanes, styles widened to match.
+// Only the final add and rotate are on the dependency chain. Returns the
+// number of cells consumed.
+static TUI_TARGET_AVX2 size_t hash_row_avx2(uint64_t acc[4], const uint32_t* g_row,
+                                            const uint16_t* s_row, size_t w) {
+    size_t i = 0;
+    __m256i vacc = _mm256_loadu_si256((const __m256i*)acc);
+    const __m256i glyph_key = _mm256_set1_epi32((int)HASH_GLYPH_KEY);
+    const __m256i style_key = _mm256_set1_epi32((int)HASH_STYLE_KEY);
+    for (; i + 8 <= w; i += 8) {
+        __m256i g = _mm256_loadu_si256((const __m256i*)(g_row + i));
+        __m256i st = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(s_row + i)));
+        __m256i kg = _mm256_xor_si256(g, glyph_key);
+        __m256i ks = _mm256_xor_si256(st, style_key);
         
-        // Handle remainder
-        for (; x < width; x++) {
-            cells[y][x] = ' ';
+        __m256i products = _mm256_add_epi64(_mm256_mul_epu32(kg, ks),
+                                             _mm256_mul_epu32(_mm256_srli_epi64(kg, 32), _mm256_srli_epi64(ks, 32)));
+        __m256i sum = _mm256_add_epi64(products, _mm256_add_epi64(g, st));
+        vacc = _mm256_add_epi64(vacc, sum);
+        vacc = _mm256_or_si256(_mm256_slli_epi64(vacc, 17), _mm256_srli_epi64(vacc, 47));
+    }
+    _mm256_storeu_si256((__m256i*)acc, vacc);
+    return i;
+}
+#endif
+
+uint64_t fast_hash_cells(const uint32_t* glyphs, const uint16_t* styles, size_t stride,
+                         size_t w, size_t h) {
+    uint64_t acc[4] = { HASH_PRIME_1, HASH_PRIME_2, ~HASH_PRIME_1, w * HASH_PRIME_2 + h };
+    #if TUI_AVX2_DISPATCH
+    bool avx2 = has_avx2();
+    #endif
+    
+    for (size_t y = 0; y < h; y++) {
+        const uint32_t* g_row = glyphs + y * stride;
+        const uint16_t* s_row = styles + y * stride;
+        size_t i = 0;
+        
+        #if TUI_AVX2_DISPATCH
+        if (avx2) i = hash_row_avx2(acc, g_row, s_row, w);
+        #endif
+        
+        for (; i + 8 <= w; i += 8) {
+            for (int lane = 0; lane < 4; lane++) {
+                acc[lane] = hash_lane(acc[lane], g_row + i + 2 * lane, s_row + i + 2 * lane);
+            }
+        }
+        // Row tail goes into the first lane one cell at a time
+        for (; i < w; i++) {
+            uint64_t cell = g_row[i] | (uint64_t)s_row[i] << 32;
+            acc[0] = rotl64(acc[0] ^ (cell * HASH_PRIME_2), 31) * HASH_PRIME_1;
         }
     }
-    #else
-    // Fallback implementation
-    for (size_t y = 0; y < height; y++) {
-        if (cells[y]) {
-            fast_memset_pattern(cells[y], ' ', width);
+    
+    uint64_t hash = rotl64(acc[0], 1) + rotl64(acc[1], 7) + rotl64(acc[2], 12) + rotl64(acc[3], 18);
+    
+    // Final avalanche so nearby inputs land far apart
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME_1;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+// Store all four glyph bytes and advance by the UTF-8 length of the lead byte
+static inline char* put_glyph(char* out, uint32_t glyph) {
+    out[0] = (char)(glyph & 0xFF);
+    out[1] = (char)((glyph >> 8) & 0xFF);
+    out[2] = (char)((glyph >> 16) & 0xFF);
+    out[3] = (char)(glyph >> 24);
+    unsigned char lead = glyph & 0xFF;
+    size_t length = lead < 0x80 ? 1 : (lead & 0xE0) == 0xC0 ? 2 : (lead & 0xF0) == 0xE0 ? 3 : 4;
+    return out + length;
+}
+
+#if TUI_AVX2_DISPATCH
+// Encodes whole blocks of 8 glyphs; returns how many glyphs it consumed
+static TUI_TARGET_AVX2 size_t encode_glyph_blocks_avx2(const uint32_t* glyphs, size_t count, char*& out) {
+    size_t i = 0;
+    const __m256i non_ascii = _mm256_set1_epi32(~0x7F);
+    // Gather the low byte of each 32-bit lane into the bottom of each 128-bit half
+    const __m256i pack = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                          0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    while (i + 8 <= count) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)(glyphs + i));
+        if (_mm256_testz_si256(chunk, non_ascii)) {
+            __m256i packed = _mm256_shuffle_epi8(chunk, pack);
+            uint32_t lo = (uint32_t)_mm256_extract_epi32(packed, 0);
+            uint32_t hi = (uint32_t)_mm256_extract_epi32(packed, 4);
+            memcpy(out, &lo, 4);
+            memcpy(out + 4, &hi, 4);
+            out += 8;
+            i += 8;
+        } else {
+            // Box drawing and other multi-byte glyphs in this block
+            for (size_t end = i + 8; i < end; i++) {
+                out = put_glyph(out, glyphs[i]);
+            }
         }
     }
+    return i;
+}
+#endif
+
+size_t fast_encode_glyph_run(const uint32_t* glyphs, size_t count, char* out) {
+    char* start = out;
+    size_t i = 0;
+    
+    #if TUI_AVX2_DISPATCH
+    if (has_avx2()) i = encode_glyph_blocks_avx2(glyphs, count, out);
     #endif
+    
+    for (; i < count; i++) {
+        out = put_glyph(out, glyphs[i]);
+    }
+    return out - start;
+}
+
+void* aligned_alloc_simd(size_t bytes) {
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, 32, bytes == 0 ? 32 : bytes) != 0) {
+        return nullptr;
+    }
+    return ptr;
+}
+
+void aligned_free_simd(void* ptr) {
+    free(ptr);
 }
 
 // Advanced SIMD string operations for terminal rendering
@@ -357,50 +1013,23 @@ size_t fast_string_compare_colors(const char* color1, const char* color2, size_t
     return max_len;
 }
 
-// Vectorized box drawing optimization
-void fast_draw_box_borders(char** cells, char** colors, int x, int y, int w, int h,
-                          char corner_char, char horizontal_char, char vertical_char,
-                          const char* color) {
-    #ifdef __SSE2__
-    // Optimized horizontal border drawing
-    if (w >= 16) {
-        __m128i h_char_vec = _mm_set1_epi8(horizontal_char);
-        
-        // Top border (skip corners)
-        for (int i = 1; i < w - 1; i += 16) {
-            int chunk_size = std::min(16, w - 1 - i);
-            for (int j = 0; j < chunk_size; j++) {
-                if (cells[y]) cells[y][x + i + j] = horizontal_char;
-            }
-        }
-        
-        // Bottom border (skip corners) 
-        for (int i = 1; i < w - 1; i += 16) {
-            int chunk_size = std::min(16, w - 1 - i);
-            for (int j = 0; j < chunk_size; j++) {
-                if (cells[y + h - 1]) cells[y + h - 1][x + i + j] = horizontal_char;
-            }
-        }
-    }
-    #endif
+// Vectorized box drawing: corners as single stores, edges as row
+// broadcasts (top/bottom) and strided stores (left/right)
+void fast_draw_box_borders(uint32_t* glyphs, uint16_t* styles, size_t stride,
+                           size_t w, size_t h, const BoxGlyphs& box, uint16_t style) {
+    size_t bottom = (h - 1) * stride;
     
-    // Always handle corners individually
-    if (cells[y]) {
-        cells[y][x] = corner_char;
-        cells[y][x + w - 1] = corner_char;
-    }
-    if (cells[y + h - 1]) {
-        cells[y + h - 1][x] = corner_char;
-        cells[y + h - 1][x + w - 1] = corner_char;
-    }
+    glyphs[0] = box.top_left;
+    glyphs[w - 1] = box.top_right;
+    glyphs[bottom] = box.bottom_left;
+    glyphs[bottom + w - 1] = box.bottom_right;
+    styles[0] = styles[w - 1] = styles[bottom] = styles[bottom + w - 1] = style;
     
-    // Vertical borders
-    for (int i = 1; i < h - 1; i++) {
-        if (cells[y + i]) {
-            cells[y + i][x] = vertical_char;
-            cells[y + i][x + w - 1] = vertical_char;
-        }
-    }
+    fast_draw_horizontal_line(glyphs + 1, styles + 1, w - 2, box.horizontal, style);
+    fast_draw_horizontal_line(glyphs + bottom + 1, styles + bottom + 1, w - 2, box.horizontal, style);
+    
+    fast_draw_vertical_line(glyphs + stride, styles + stride, stride, h - 2, box.vertical, style);
+    fast_draw_vertical_line(glyphs + stride + w - 1, styles + stride + w - 1, stride, h - 2, box.vertical, style);
 }
 
 // CPU cache optimization - prefetch data for next operations
@@ -0,0 +1,145 @@
+#include "../include/band_encoder.h"
+#include "../include/worker_pool.h"
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <cerrno>
+#include <poll.h>
+#include <sys/uio.h>
+
+// Slack per band for the bytes an encoder adds outside its rows, such as a
+// home cursor move at the top of the frame
+static const size_t BAND_SLACK_BYTES = 64;
+
+// More bands than threads, so a band full of changes does not leave the
+// other threads idle while it finishes
+static const size_t BANDS_PER_THREAD = 4;
+
+size_t BandEncoder::minParallelCells = 32768;
+
+void BandEncoder::encode(int rows, int rowAlign, size_t maxRowBytes, size_t workCells,
+                         const EncodeFunction& encodeBand) {
+    WorkerPool& pool = WorkerPool::getInstance();
+    rowAlign = std::max(rowAlign, 1);
+    
+    size_t units = rows > 0 ? (size_t)(rows + rowAlign - 1) / rowAlign : 0;
+    size_t count = std::min(units, (pool.getWorkerCount() + 1) * BANDS_PER_THREAD);
+    if (workCells < minParallelCells || count == 0) {
+        count = 1;
+    }
+    size_t unitsPerBand = units ? (units + count - 1) / count : 0;
+    count = unitsPerBand ? (units + unitsPerBand - 1) / unitsPerBand : 1;
+    
+    if (bands.size() < count) {
+        bands.resize(count);
+    }
+    bandCount = count;
+    for (size_t i = 0; i < count; i++) {
+        Band& band = bands[i];
+        band.y0 = std::min(rows, (int)(i * unitsPerBand) * rowAlign);
+        band.y1 = std::min(rows, (int)((i + 1) * unitsPerBand) * rowAlign);
+        band.length = 0;
+        
+        size_t capacity = (size_t)(band.y1 - band.y0) * maxRowBytes + BAND_SLACK_BYTES;
+        if (band.arena.size() < capacity) {
+            band.arena.resize(capacity);
+        }
+    }
+    
+    std::function<void(size_t)> run = [&](size_t i) {
+        Band& band = bands[i];
+        char* start = &band.arena[0];
+        band.length = encodeBand(band.y0, band.y1, start) - start;
+    };
+    if (count == 1) {
+        run(0);
+    } else {
+        pool.parallelFor(count, run);
+    }
+}
+
+size_t BandEncoder::size() const {
+    size_t total = 0;
+    for (size_t i = 0; i < bandCount; i++) {
+        total += bands[i].length;
+    }
+    return total;
+}
+
+void BandEncoder::appendTo(std::string& out) const {
+    for (size_t i = 0; i < bandCount; i++) {
+        out.append(bands[i].arena.data(), bands[i].length);
+    }
+}
+
+void BandEncoder::collectChunks(std::vector<iovec>& chunks, const std::string& head, const std::string& tail) const {
+    chunks.reserve(bandCount + 2);
+    
+    auto add = [&](const char* data, size_t length) {
+        if (length == 0) return;
+        iovec chunk;
+        chunk.iov_base = const_cast<char*>(data);
+        chunk.iov_len = length;
+        chunks.push_back(chunk);
+    };
+    add(head.data(), head.size());
+    for (size_t i = 0; i < bandCount; i++) {
+        add(bands[i].arena.data(), bands[i].length);
+    }
+    add(tail.data(), tail.size());
+}
+
+// Writes chunks from `first` on, advancing it past what went out. With
+// `wait`, polls through EAGAIN until everything is written; without, stops
+// there. Returns false on a write error.
+static bool writeChunks(int fd, std::vector<iovec>& chunks, size_t& first, bool wait) {
+    while (first < chunks.size()) {
+        ssize_t written = writev(fd, &chunks[first], (int)std::min<size_t>(chunks.size() - first, IOV_MAX));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (!wait) return true;
+                pollfd ready = { fd, POLLOUT, 0 };
+                poll(&ready, 1, -1);
+                continue;
+            }
+            return false;
+        }
+        
+        // Step past what was written, leaving a partly written chunk trimmed
+        size_t left = (size_t)written;
+        while (first < chunks.size() && left >= chunks[first].iov_len) {
+            left -= chunks[first].iov_len;
+            first++;
+        }
+        if (left) {
+            chunks[first].iov_base = (char*)chunks[first].iov_base + left;
+            chunks[first].iov_len -= left;
+        }
+    }
+    return true;
+}
+
+bool BandEncoder::writeTo(int fd, const std::string& head, const std::string& tail) const {
+    std::vector<iovec> chunks;
+    collectChunks(chunks, head, tail);
+    
+    // Anything still buffered in std::cout has to reach the terminal first
+    std::cout.flush();
+    
+    size_t first = 0;
+    return writeChunks(fd, chunks, first, true);
+}
+
+bool BandEncoder::writeAvailable(int fd, const std::string& head, const std::string& tail, std::string& rest) const {
+    std::vector<iovec> chunks;
+    collectChunks(chunks, head, tail);
+    std::cout.flush();
+    
+    size_t first = 0;
+    bool ok = writeChunks(fd, chunks, first, false);
+    for (; first < chunks.size(); first++) {
+        rest.append((const char*)chunks[first].iov_base, chunks[first].iov_len);
+    }
+    return ok;
+}
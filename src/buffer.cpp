@@ -1,8 +1,10 @@
 #include "../include/buffer.h"
 #include "../include/asm_optimized.h"
+#include "../include/display_list.h"
 #include <iostream>
-#include <sstream>
+#include <cstring>
 #include <algorithm>
+#include <unistd.h>
 
 // Unicode utility functions
 int UnicodeUtils::getDisplayWidth(const std::string& text) {
@@ -44,133 +46,680 @@ std::string UnicodeUtils::substring(const std::string& text, int start, int leng
     return result;
 }
 
-UnicodeBuffer::UnicodeBuffer(int w, int h) : width(w), height(h) {
-    cells.resize(height, std::vector<std::string>(width, " "));
-    colors.resize(height, std::vector<std::string>(width, Color::RESET));
+uint32_t UnicodeUtils::encodeGlyph(const char* text, size_t length) {
+    if (length == 0) return ' ';
+    
+    uint32_t glyph = 0;
+    size_t n = nextCharLength(text, length);
+    for (size_t i = 0; i < n; i++) {
+        glyph |= (uint32_t)(unsigned char)text[i] << (8 * i);
+    }
+    return glyph;
+}
+
+int UnicodeUtils::glyphByteLength(uint32_t glyph) {
+    // The UTF-8 lead byte sits in the low byte and encodes the sequence length
+    unsigned char lead = glyph & 0xFF;
+    if (lead < 0x80) return 1;
+    if ((lead & 0xE0) == 0xC0) return 2;
+    if ((lead & 0xF0) == 0xE0) return 3;
+    return 4;
+}
+
+size_t UnicodeUtils::nextCharLength(const char* text, size_t remaining) {
+    if (remaining == 0) return 0;
+    size_t n = 1;
+    while (n < remaining && n < 4 && (text[n] & 0xC0) == 0x80) {
+        n++;
+    }
+    return n;
+}
+
+void AlignedPlaneDeleter::operator()(void* ptr) const {
+    ASMOptimized::aligned_free_simd(ptr);
+}
+
+static const uint32_t SPACE_GLYPH = ' ';
+static uint32_t nextBufferId = 1;
+
+UnicodeBuffer::UnicodeBuffer(int w, int h)
+    : width(std::max(0, w)), height(std::max(0, h)), currentOwner(0), lastStyleId(0), maxStyleLength(Color::RESET.size()),
+      instanceId(nextBufferId++), exportTarget(0), recorder(nullptr), recordBase(0), modCount(0) {
+    // Pad rows to 16 cells so both the 4-byte and 2-byte planes keep
+    // every row start on a 32-byte boundary
+    stride = (width + 15) & ~15;
+    size_t count = (size_t)stride * height;
+    glyphs.reset((uint32_t*)ASMOptimized::aligned_alloc_simd(count * sizeof(uint32_t)));
+    styles.reset((StyleId*)ASMOptimized::aligned_alloc_simd(count * sizeof(StyleId)));
+#if TUI_PICK_BUFFER
+    owners.reset((uint32_t*)ASMOptimized::aligned_alloc_simd(count * sizeof(uint32_t)));
+#endif
+    
+    tileColumns = (width + TILE_WIDTH - 1) / TILE_WIDTH;
+    tileRows = (height + TILE_HEIGHT - 1) / TILE_HEIGHT;
+    tileVersions.assign((size_t)tileColumns * tileRows, 0);
+    
+    styleTable.push_back(Color::RESET);
+    styleLookup[Color::RESET] = 0;
+    
+    ClipState root;
+    root.clip = Rect(0, 0, width, height);
+    root.dx = 0;
+    root.dy = 0;
+    clipStack.push_back(root);
+    
+    clear();
+}
+
+StyleId UnicodeBuffer::internStyle(const std::string& color) {
+    // Widgets draw long runs with the same color, so check the last style
+    // before paying for a hash lookup
+    const std::string& last = styleTable[lastStyleId];
+    if (ASMOptimized::fast_string_equal(color.data(), color.size(), last.data(), last.size())) {
+        return lastStyleId;
+    }
+    
+    auto it = styleLookup.find(color);
+    if (it != styleLookup.end()) {
+        lastStyleId = it->second;
+        return lastStyleId;
+    }
+    
+    if (styleTable.size() > 0xFFFF) {
+        return 0; // Table full, fall back to reset
+    }
+    
+    StyleId id = (StyleId)styleTable.size();
+    styleTable.push_back(color);
+    styleLookup[color] = id;
+    lastStyleId = id;
+    maxStyleLength = std::max(maxStyleLength, color.size());
+    return id;
+}
+
+void UnicodeBuffer::pushClip(const Rect& rect) {
+    ClipState state = current();
+    state.clip = Rect(rect.x + state.dx, rect.y + state.dy, rect.w, rect.h).intersect(state.clip);
+    clipStack.push_back(state);
+}
+
+void UnicodeBuffer::pushTranslation(int dx, int dy) {
+    ClipState state = current();
+    state.dx += dx;
+    state.dy += dy;
+    clipStack.push_back(state);
+}
+
+void UnicodeBuffer::pushViewport(const Rect& rect) {
+    ClipState state = current();
+    state.clip = Rect(rect.x + state.dx, rect.y + state.dy, rect.w, rect.h).intersect(state.clip);
+    state.dx += rect.x;
+    state.dy += rect.y;
+    clipStack.push_back(state);
+}
+
+void UnicodeBuffer::pop() {
+    if (clipStack.size() > 1) {
+        clipStack.pop_back();
+    }
+}
+
+Rect UnicodeBuffer::getClip() const {
+    const ClipState& state = current();
+    return Rect(state.clip.x - state.dx, state.clip.y - state.dy, state.clip.w, state.clip.h);
 }
 
 void UnicodeBuffer::clear() {
-    // Use ASM optimization for larger buffers
-    if (ASMOptimized::has_avx2() && width * height > 200) {
-        ASMOptimized::fast_buffer_clear_optimized(cells, colors, width, height);
-    } else {
-        // Standard implementation for small buffers
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                cells[y][x] = " ";
-                colors[y][x] = Color::RESET;
-            }
+    ASMOptimized::fast_buffer_clear_optimized(glyphs.get(), styles.get(),
+                                              (size_t)stride * height, SPACE_GLYPH, 0);
+    if (owners) {
+        std::fill(owners.get(), owners.get() + (size_t)stride * height, 0u);
+    }
+    std::fill(tileVersions.begin(), tileVersions.end(), ++modCount);
+}
+
+bool UnicodeBuffer::hasPickBuffer() {
+    return TUI_PICK_BUFFER != 0;
+}
+
+uint32_t UnicodeBuffer::allocateOwnerId() {
+    static uint32_t nextOwnerId = 1;
+    return nextOwnerId++;
+}
+
+uint32_t UnicodeBuffer::ownerAt(int x, int y) const {
+    if (!owners || x < 0 || y < 0 || x >= width || y >= height) return 0;
+    return owners.get()[(size_t)y * stride + x];
+}
+
+Rect UnicodeBuffer::tileRect(int tx, int ty) const {
+    return Rect(tx * TILE_WIDTH, ty * TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT).intersect(Rect(0, 0, width, height));
+}
+
+uint64_t UnicodeBuffer::tileHash(int tx, int ty) const {
+    Rect area = tileRect(tx, ty);
+    return ASMOptimized::fast_hash_cells(glyphRow(area.y) + area.x, styleRow(area.y) + area.x, stride,
+                                         area.w, area.h);
+}
+
+void UnicodeBuffer::snapshotFrom(const UnicodeBuffer& src) {
+    if (src.width != width || src.height != height) return;
+    
+    // Style tables only grow, so a table copied from the same buffer is a
+    // prefix of the current one
+    uint64_t since = modCount;
+    if (src.instanceId != instanceId) {
+        styleTable.clear();
+        styleLookup.clear();
+        lastStyleId = 0;
+        since = 0;
+    }
+    while (styleTable.size() < src.styleTable.size()) {
+        const std::string& style = src.styleTable[styleTable.size()];
+        styleLookup[style] = (StyleId)styleTable.size();
+        styleTable.push_back(style);
+    }
+    maxStyleLength = src.maxStyleLength;
+    
+    for (int ty = 0; ty < tileRows; ty++) {
+        for (int tx = 0; tx < tileColumns; tx++) {
+            if (src.tileVersions[(size_t)ty * tileColumns + tx] <= since) continue;
+            Rect area = tileRect(tx, ty);
+            size_t offset = (size_t)area.y * stride + area.x;
+            ASMOptimized::fast_blit_cells(glyphs.get() + offset, styles.get() + offset, stride,
+                                          src.glyphs.get() + offset, src.styles.get() + offset, src.stride,
+                                          area.w, area.h, nullptr);
+        }
+    }
+    
+    tileVersions = src.tileVersions;
+    modCount = src.modCount;
+    instanceId = src.instanceId;
+    exportTarget = 0;
+}
+
+// Drawing primitives shared by UnicodeBuffer and BufferView. Coordinates
+// are already translated; each primitive intersects with the clip once and
+// then stores cells without further checks.
+
+// Stamp the tiles overlapping a non-empty, already clipped area
+static void markTiles(uint64_t* versions, int columns, uint64_t stamp, int x, int y, int w, int h) {
+    int tx0 = x / UnicodeBuffer::TILE_WIDTH;
+    int tx1 = (x + w - 1) / UnicodeBuffer::TILE_WIDTH;
+    int ty0 = y / UnicodeBuffer::TILE_HEIGHT;
+    int ty1 = (y + h - 1) / UnicodeBuffer::TILE_HEIGHT;
+    for (int ty = ty0; ty <= ty1; ty++) {
+        uint64_t* row = versions + (size_t)ty * columns;
+        for (int tx = tx0; tx <= tx1; tx++) {
+            row[tx] = stamp;
         }
     }
 }
 
+static void markTiles(const CellTarget& t, int x, int y, int w, int h) {
+    markTiles(t.tileVersions, t.tileColumns, t.stamp, x, y, w, h);
+}
+
+// Claim a non-empty, already clipped area for the target's owner
+#if TUI_PICK_BUFFER
+static void putOwners(const CellTarget& t, int x, int y, int w, int h) {
+    uint32_t* row = t.owners + (size_t)y * t.stride + x;
+    for (int i = 0; i < h; i++, row += t.stride) {
+        std::fill(row, row + w, t.owner);
+    }
+}
+#else
+static inline void putOwners(const CellTarget&, int, int, int, int) {}
+#endif
+
+static void putCell(const CellTarget& t, int x, int y, uint32_t glyph, StyleId style) {
+    if (t.clip.contains(x, y)) {
+        size_t index = (size_t)y * t.stride + x;
+        t.glyphs[index] = glyph;
+        t.styles[index] = style;
+        putOwners(t, x, y, 1, 1);
+        markTiles(t, x, y, 1, 1);
+    }
+}
+
+static void putHLine(const CellTarget& t, int x, int y, int length, uint32_t glyph, StyleId style) {
+    const Rect& clip = t.clip;
+    if (y < clip.y || y >= clip.y + clip.h) return;
+    int x0 = std::max(clip.x, x);
+    int x1 = std::min(clip.x + clip.w, x + length);
+    if (x0 >= x1) return;
+    
+    size_t offset = (size_t)y * t.stride + x0;
+    ASMOptimized::fast_draw_horizontal_line(t.glyphs + offset, t.styles + offset,
+                                            x1 - x0, glyph, style);
+    putOwners(t, x0, y, x1 - x0, 1);
+    markTiles(t, x0, y, x1 - x0, 1);
+}
+
+static void putVLine(const CellTarget& t, int x, int y, int length, uint32_t glyph, StyleId style) {
+    const Rect& clip = t.clip;
+    if (x < clip.x || x >= clip.x + clip.w) return;
+    int y0 = std::max(clip.y, y);
+    int y1 = std::min(clip.y + clip.h, y + length);
+    if (y0 >= y1) return;
+    
+    size_t offset = (size_t)y0 * t.stride + x;
+    ASMOptimized::fast_draw_vertical_line(t.glyphs + offset, t.styles + offset,
+                                          t.stride, y1 - y0, glyph, style);
+    putOwners(t, x, y0, 1, y1 - y0);
+    markTiles(t, x, y0, 1, y1 - y0);
+}
+
+static void putText(const CellTarget& t, int x, int y, const char* text, size_t length, StyleId style, int limitX) {
+    const Rect& clip = t.clip;
+    if (y < clip.y || y >= clip.y + clip.h) return;
+    int x1 = std::min(clip.x + clip.w, limitX);
+    
+    const char* p = text;
+    size_t remaining = length;
+    
+    // Characters left of the clip are skipped, not stored
+    int col = x;
+    while (remaining > 0 && col < clip.x) {
+        size_t n = UnicodeUtils::nextCharLength(p, remaining);
+        p += n;
+        remaining -= n;
+        col++;
+    }
+    
+    uint32_t* glyphOut = t.glyphs + (size_t)y * t.stride;
+    StyleId* styleOut = t.styles + (size_t)y * t.stride;
+    int start = col;
+    for (; remaining > 0 && col < x1; col++) {
+        size_t n = UnicodeUtils::nextCharLength(p, remaining);
+        glyphOut[col] = UnicodeUtils::encodeGlyph(p, n);
+        styleOut[col] = style;
+        p += n;
+        remaining -= n;
+    }
+    if (col > start) {
+        putOwners(t, start, y, col - start, 1);
+        markTiles(t, start, y, col - start, 1);
+    }
+}
+
+static void putRect(const CellTarget& t, int x, int y, int w, int h, uint32_t glyph, StyleId style) {
+    // Clip once, then hand whole rows to the fill kernel
+    Rect area = Rect(x, y, w, h).intersect(t.clip);
+    if (area.empty()) return;
+    
+    size_t offset = (size_t)area.y * t.stride + area.x;
+    ASMOptimized::fast_rect_fill(t.glyphs + offset, t.styles + offset, t.stride,
+                                 area.w, area.h, glyph, style);
+    putOwners(t, area.x, area.y, area.w, area.h);
+    markTiles(t, area.x, area.y, area.w, area.h);
+}
+
+static ASMOptimized::BoxGlyphs encodeBoxGlyphs(const std::string& topLeft, const std::string& topRight,
+                                               const std::string& bottomLeft, const std::string& bottomRight,
+                                               const std::string& horizontal, const std::string& vertical) {
+    ASMOptimized::BoxGlyphs box;
+    box.top_left = UnicodeUtils::encodeGlyph(topLeft);
+    box.top_right = UnicodeUtils::encodeGlyph(topRight);
+    box.bottom_left = UnicodeUtils::encodeGlyph(bottomLeft);
+    box.bottom_right = UnicodeUtils::encodeGlyph(bottomRight);
+    box.horizontal = UnicodeUtils::encodeGlyph(horizontal);
+    box.vertical = UnicodeUtils::encodeGlyph(vertical);
+    return box;
+}
+
+static void putBox(const CellTarget& t, int x, int y, int w, int h, StyleId style, bool rounded, bool heavy) {
+    // Border glyphs are encoded once, not per cell
+    static const ASMOptimized::BoxGlyphs heavyBox = encodeBoxGlyphs(
+        Unicode::HEAVY_TOP_LEFT, Unicode::HEAVY_TOP_RIGHT, Unicode::HEAVY_BOTTOM_LEFT,
+        Unicode::HEAVY_BOTTOM_RIGHT, Unicode::HEAVY_HORIZONTAL, Unicode::HEAVY_VERTICAL);
+    static const ASMOptimized::BoxGlyphs roundedBox = encodeBoxGlyphs(
+        Unicode::ROUND_TOP_LEFT, Unicode::ROUND_TOP_RIGHT, Unicode::ROUND_BOTTOM_LEFT,
+        Unicode::ROUND_BOTTOM_RIGHT, Unicode::HORIZONTAL, Unicode::VERTICAL);
+    static const ASMOptimized::BoxGlyphs doubleBox = encodeBoxGlyphs(
+        Unicode::DOUBLE_TOP_LEFT, Unicode::DOUBLE_TOP_RIGHT, Unicode::DOUBLE_BOTTOM_LEFT,
+        Unicode::DOUBLE_BOTTOM_RIGHT, Unicode::DOUBLE_HORIZONTAL, Unicode::DOUBLE_VERTICAL);
+    
+    const ASMOptimized::BoxGlyphs& box = heavy ? heavyBox : (rounded ? roundedBox : doubleBox);
+    
+    // Common case: the whole box is inside the clip, draw it without any clipping
+    const Rect& clip = t.clip;
+    if (w >= 2 && h >= 2 && x >= clip.x && y >= clip.y &&
+        x + w <= clip.x + clip.w && y + h <= clip.y + clip.h) {
+        size_t offset = (size_t)y * t.stride + x;
+        ASMOptimized::fast_draw_box_borders(t.glyphs + offset, t.styles + offset,
+                                            t.stride, w, h, box, style);
+        putOwners(t, x, y, w, 1);
+        putOwners(t, x, y + h - 1, w, 1);
+        putOwners(t, x, y + 1, 1, h - 2);
+        putOwners(t, x + w - 1, y + 1, 1, h - 2);
+        markTiles(t, x, y, w, h);
+        return;
+    }
+    
+    // Partially visible: each edge is clipped once as a line primitive
+    putCell(t, x, y, box.top_left, style);
+    putHLine(t, x + 1, y, w - 2, box.horizontal, style);
+    putCell(t, x + w - 1, y, box.top_right, style);
+    
+    putVLine(t, x, y + 1, h - 2, box.vertical, style);
+    putVLine(t, x + w - 1, y + 1, h - 2, box.vertical, style);
+    
+    putCell(t, x, y + h - 1, box.bottom_left, style);
+    putHLine(t, x + 1, y + h - 1, w - 2, box.horizontal, style);
+    putCell(t, x + w - 1, y + h - 1, box.bottom_right, style);
+}
+
+CellTarget UnicodeBuffer::target() {
+    const ClipState& state = current();
+    CellTarget t;
+    t.glyphs = glyphs.get();
+    t.styles = styles.get();
+    t.owners = owners.get();
+    t.owner = currentOwner;
+    t.stride = stride;
+    t.clip = state.clip;
+    t.dx = state.dx;
+    t.dy = state.dy;
+    t.tileVersions = tileVersions.data();
+    t.tileColumns = tileColumns;
+    t.stamp = ++modCount;
+    return t;
+}
+
+BufferView UnicodeBuffer::view(const Rect& area) {
+    CellTarget t = target();
+    t.clip = Rect(area.x + t.dx, area.y + t.dy, area.w, area.h).intersect(t.clip);
+    t.dx += area.x;
+    t.dy += area.y;
+    return BufferView(*this, t, area.w, area.h);
+}
+
 void UnicodeBuffer::setCell(int x, int y, const std::string& ch, const std::string& color) {
-    if (x >= 0 && x < width && y >= 0 && y < height) {
-        cells[y][x] = ch;
-        colors[y][x] = color;
+    CellTarget t = target();
+    if (recorder) {
+        recorder->recordCell(t.clip, x + t.dx, y + t.dy, UnicodeUtils::encodeGlyph(ch), color);
+    } else if (t.clip.contains(x + t.dx, y + t.dy)) {
+        putCell(t, x + t.dx, y + t.dy, UnicodeUtils::encodeGlyph(ch), internStyle(color));
     }
 }
 
 void UnicodeBuffer::drawString(int x, int y, const std::string& text, const std::string& color) {
-    auto chars = UnicodeUtils::splitIntoChars(text);
-    for (size_t i = 0; i < chars.size() && x + (int)i < width; i++) {
-        setCell(x + (int)i, y, chars[i], color);
+    CellTarget t = target();
+    if (recorder) {
+        recorder->recordText(t.clip, x + t.dx, y + t.dy, text, color, t.clip.x + t.clip.w);
+        return;
     }
+    putText(t, x + t.dx, y + t.dy, text.data(), text.size(), internStyle(color), t.clip.x + t.clip.w);
 }
 
 void UnicodeBuffer::drawStringClipped(int x, int y, const std::string& text, const std::string& color, int maxX) {
-    auto chars = UnicodeUtils::splitIntoChars(text);
-    for (size_t i = 0; i < chars.size() && x + (int)i < width && x + (int)i < maxX; i++) {
-        setCell(x + (int)i, y, chars[i], color);
+    CellTarget t = target();
+    if (recorder) {
+        recorder->recordText(t.clip, x + t.dx, y + t.dy, text, color, maxX + t.dx);
+        return;
+    }
+    putText(t, x + t.dx, y + t.dy, text.data(), text.size(), internStyle(color), maxX + t.dx);
+}
+
+void UnicodeBuffer::drawHLine(int x, int y, int length, const std::string& ch, const std::string& color) {
+    CellTarget t = target();
+    if (recorder) {
+        recorder->recordHLine(t.clip, x + t.dx, y + t.dy, length, UnicodeUtils::encodeGlyph(ch), color);
+        return;
     }
+    putHLine(t, x + t.dx, y + t.dy, length, UnicodeUtils::encodeGlyph(ch), internStyle(color));
+}
+
+void UnicodeBuffer::drawVLine(int x, int y, int length, const std::string& ch, const std::string& color) {
+    CellTarget t = target();
+    if (recorder) {
+        recorder->recordVLine(t.clip, x + t.dx, y + t.dy, length, UnicodeUtils::encodeGlyph(ch), color);
+        return;
+    }
+    putVLine(t, x + t.dx, y + t.dy, length, UnicodeUtils::encodeGlyph(ch), internStyle(color));
 }
 
 void UnicodeBuffer::drawBox(int x, int y, int w, int h, const std::string& color, bool rounded, bool heavy) {
-    std::string topLeft, topRight, bottomLeft, bottomRight, horizontal, vertical;
-    
-    if (heavy) {
-        topLeft = Unicode::HEAVY_TOP_LEFT;
-        topRight = Unicode::HEAVY_TOP_RIGHT;
-        bottomLeft = Unicode::HEAVY_BOTTOM_LEFT;
-        bottomRight = Unicode::HEAVY_BOTTOM_RIGHT;
-        horizontal = Unicode::HEAVY_HORIZONTAL;
-        vertical = Unicode::HEAVY_VERTICAL;
-    } else if (rounded) {
-        topLeft = Unicode::ROUND_TOP_LEFT;
-        topRight = Unicode::ROUND_TOP_RIGHT;
-        bottomLeft = Unicode::ROUND_BOTTOM_LEFT;
-        bottomRight = Unicode::ROUND_BOTTOM_RIGHT;
-        horizontal = Unicode::HORIZONTAL;
-        vertical = Unicode::VERTICAL;
-    } else {
-        topLeft = Unicode::DOUBLE_TOP_LEFT;
-        topRight = Unicode::DOUBLE_TOP_RIGHT;
-        bottomLeft = Unicode::DOUBLE_BOTTOM_LEFT;
-        bottomRight = Unicode::DOUBLE_BOTTOM_RIGHT;
-        horizontal = Unicode::DOUBLE_HORIZONTAL;
-        vertical = Unicode::DOUBLE_VERTICAL;
-    }
-    
-    // Top border
-    setCell(x, y, topLeft, color);
-    for (int i = 1; i < w - 1; i++) {
-        setCell(x + i, y, horizontal, color);
-    }
-    setCell(x + w - 1, y, topRight, color);
-    
-    // Side borders
-    for (int i = 1; i < h - 1; i++) {
-        setCell(x, y + i, vertical, color);
-        setCell(x + w - 1, y + i, vertical, color);
-    }
-    
-    // Bottom border
-    setCell(x, y + h - 1, bottomLeft, color);
-    for (int i = 1; i < w - 1; i++) {
-        setCell(x + i, y + h - 1, horizontal, color);
-    }
-    setCell(x + w - 1, y + h - 1, bottomRight, color);
+    CellTarget t = target();
+    if (recorder) {
+        recorder->recordBox(t.clip, x + t.dx, y + t.dy, w, h, color, rounded, heavy);
+        return;
+    }
+    putBox(t, x + t.dx, y + t.dy, w, h, internStyle(color), rounded, heavy);
 }
 
 void UnicodeBuffer::fillRect(int x, int y, int w, int h, const std::string& character, const std::string& color) {
-    // Use ASM optimization for larger rectangles
-    if (ASMOptimized::has_avx2() && w * h > 32) {
-        ASMOptimized::fast_rect_fill(cells, colors, x, y, w, h, character, color);
-    } else {
-        // Standard implementation for small rectangles
-        for (int row = y; row < y + h; row++) {
-            for (int col = x; col < x + w; col++) {
-                if (row >= 0 && row < height && col >= 0 && col < width) {
-                    cells[row][col] = character;
-                    colors[row][col] = color;
-                }
-            }
-        }
+    CellTarget t = target();
+    if (recorder) {
+        recorder->recordRect(t.clip, x + t.dx, y + t.dy, w, h, UnicodeUtils::encodeGlyph(character), color);
+        return;
+    }
+    putRect(t, x + t.dx, y + t.dy, w, h, UnicodeUtils::encodeGlyph(character), internStyle(color));
+}
+
+Rect BufferView::getClip() const {
+    return Rect(target.clip.x - target.dx, target.clip.y - target.dy, target.clip.w, target.clip.h);
+}
+
+BufferView BufferView::subView(const Rect& area) const {
+    CellTarget t = target;
+    t.clip = Rect(area.x + t.dx, area.y + t.dy, area.w, area.h).intersect(t.clip);
+    t.dx += area.x;
+    t.dy += area.y;
+    return BufferView(*owner, t, area.w, area.h);
+}
+
+BufferView BufferView::clipped(const Rect& area) const {
+    CellTarget t = target;
+    t.clip = Rect(area.x + t.dx, area.y + t.dy, area.w, area.h).intersect(t.clip);
+    return BufferView(*owner, t, width, height);
+}
+
+void BufferView::setCell(int x, int y, const std::string& ch, const std::string& color) {
+    if (DisplayList* recorder = owner->getRecorder()) {
+        recorder->recordCell(target.clip, x + target.dx, y + target.dy, UnicodeUtils::encodeGlyph(ch), color);
+    } else if (target.clip.contains(x + target.dx, y + target.dy)) {
+        putCell(target, x + target.dx, y + target.dy, UnicodeUtils::encodeGlyph(ch), owner->internStyle(color));
+    }
+}
+
+void BufferView::drawString(int x, int y, const std::string& text, const std::string& color) {
+    if (DisplayList* recorder = owner->getRecorder()) {
+        recorder->recordText(target.clip, x + target.dx, y + target.dy, text, color, target.clip.x + target.clip.w);
+        return;
+    }
+    putText(target, x + target.dx, y + target.dy, text.data(), text.size(), owner->internStyle(color), target.clip.x + target.clip.w);
+}
+
+void BufferView::drawStringClipped(int x, int y, const std::string& text, const std::string& color, int maxX) {
+    if (DisplayList* recorder = owner->getRecorder()) {
+        recorder->recordText(target.clip, x + target.dx, y + target.dy, text, color, maxX + target.dx);
+        return;
+    }
+    putText(target, x + target.dx, y + target.dy, text.data(), text.size(), owner->internStyle(color), maxX + target.dx);
+}
+
+void BufferView::drawHLine(int x, int y, int length, const std::string& ch, const std::string& color) {
+    if (DisplayList* recorder = owner->getRecorder()) {
+        recorder->recordHLine(target.clip, x + target.dx, y + target.dy, length, UnicodeUtils::encodeGlyph(ch), color);
+        return;
+    }
+    putHLine(target, x + target.dx, y + target.dy, length, UnicodeUtils::encodeGlyph(ch), owner->internStyle(color));
+}
+
+void BufferView::drawVLine(int x, int y, int length, const std::string& ch, const std::string& color) {
+    if (DisplayList* recorder = owner->getRecorder()) {
+        recorder->recordVLine(target.clip, x + target.dx, y + target.dy, length, UnicodeUtils::encodeGlyph(ch), color);
+        return;
+    }
+    putVLine(target, x + target.dx, y + target.dy, length, UnicodeUtils::encodeGlyph(ch), owner->internStyle(color));
+}
+
+void BufferView::drawBox(int x, int y, int w, int h, const std::string& color, bool rounded, bool heavy) {
+    if (DisplayList* recorder = owner->getRecorder()) {
+        recorder->recordBox(target.clip, x + target.dx, y + target.dy, w, h, color, rounded, heavy);
+        return;
     }
+    putBox(target, x + target.dx, y + target.dy, w, h, owner->internStyle(color), rounded, heavy);
+}
+
+void BufferView::fillRect(int x, int y, int w, int h, const std::string& character, const std::string& color) {
+    if (DisplayList* recorder = owner->getRecorder()) {
+        recorder->recordRect(target.clip, x + target.dx, y + target.dy, w, h, UnicodeUtils::encodeGlyph(character), color);
+        return;
+    }
+    putRect(target, x + target.dx, y + target.dy, w, h, UnicodeUtils::encodeGlyph(character), owner->internStyle(color));
 }
 
 void UnicodeBuffer::render() {
-    std::ostringstream output;
-    output << "\033[H";
-    
-    std::string currentColor = "";
-    
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            // Use SIMD-optimized string comparison for color changes
-            if (ASMOptimized::has_sse2() && !ASMOptimized::fast_string_equal(colors[y][x], currentColor)) {
-                output << colors[y][x];
-                currentColor = colors[y][x];
-            } else if (!ASMOptimized::has_sse2() && colors[y][x] != currentColor) {
-                output << colors[y][x];
-                currentColor = colors[y][x];
+    // Each band starts in the style the row above it ended in, so the
+    // joined bands are byte for byte what one sequential pass would write
+    frameBands.encode(height, TILE_HEIGHT, (size_t)width * (4 + maxStyleLength) + 2, (size_t)width * height,
+                      [this](int y0, int y1, char* out) {
+        int currentStyle = y0 > 0 && width > 0 ? styleRow(y0 - 1)[width - 1] : -1;
+        
+        for (int y = y0; y < y1; y++) {
+            out = encodeSpan(out, y, 0, width, currentStyle);
+            if (y < height - 1) {
+                memcpy(out, "\r\n", 2);
+                out += 2;
             }
-            output << cells[y][x];
         }
-        if (y < height - 1) output << "\r\n";
+        return out;
+    });
+    
+    frameBands.writeTo(STDOUT_FILENO, "\033[H", Color::RESET);
+}
+
+char* UnicodeBuffer::encodeSpan(char* out, int y, int x0, int x1, int& currentStyle) const {
+    const uint32_t* glyphRow = glyphs.get() + (size_t)y * stride;
+    const StyleId* styleRow = styles.get() + (size_t)y * stride;
+    
+    // One SGR per style run, then the run's glyphs copied out contiguously
+    size_t x = x0;
+    while (x < (size_t)x1) {
+        size_t run = ASMOptimized::fast_style_run_length(styleRow + x, x1 - x);
+        
+        if (styleRow[x] != currentStyle) {
+            const std::string& sgr = styleTable[styleRow[x]];
+            memcpy(out, sgr.data(), sgr.size());
+            out += sgr.size();
+            currentStyle = styleRow[x];
+        }
+        
+        out += ASMOptimized::fast_encode_glyph_run(glyphRow + x, run, out);
+        x += run;
+    }
+    return out;
+}
+
+void UnicodeBuffer::blit(const UnicodeBuffer& src, int srcX, int srcY, int w, int h, int dstX, int dstY) {
+    // The recording clip is unbounded and cells are not recorded
+    if (recorder) return;
+    
+    dstX += current().dx;
+    dstY += current().dy;
+    
+    // Clip against the source and the destination clip once for the whole block
+    const Rect& clip = current().clip;
+    if (srcX < 0) { w += srcX; dstX -= srcX; srcX = 0; }
+    if (srcY < 0) { h += srcY; dstY -= srcY; srcY = 0; }
+    if (dstX < clip.x) { w -= clip.x - dstX; srcX += clip.x - dstX; dstX = clip.x; }
+    if (dstY < clip.y) { h -= clip.y - dstY; srcY += clip.y - dstY; dstY = clip.y; }
+    w = std::min(w, std::min(src.width - srcX, clip.x + clip.w - dstX));
+    h = std::min(h, std::min(src.height - srcY, clip.y + clip.h - dstY));
+    if (w <= 0 || h <= 0) return;
+    
+    // Each buffer interns its own styles; translate ids only for styles
+    // added to the source since the last blit into this buffer
+    if (src.exportTarget != instanceId) {
+        src.exportMap.clear();
+        src.exportTarget = instanceId;
+    }
+    while (src.exportMap.size() < src.styleTable.size()) {
+        src.exportMap.push_back(internStyle(src.styleTable[src.exportMap.size()]));
+    }
+    
+    size_t dstOffset = (size_t)dstY * stride + dstX;
+    size_t srcOffset = (size_t)srcY * src.stride + srcX;
+    ASMOptimized::fast_blit_cells(glyphs.get() + dstOffset, styles.get() + dstOffset, stride,
+                                  src.glyphs.get() + srcOffset, src.styles.get() + srcOffset, src.stride,
+                                  w, h, src.exportMap.data());
+#if TUI_PICK_BUFFER
+    for (int row = 0; row < h; row++) {
+        uint32_t* dst = owners.get() + dstOffset + (size_t)row * stride;
+        const uint32_t* from = src.owners.get() + srcOffset + (size_t)row * src.stride;
+        for (int i = 0; i < w; i++) {
+            dst[i] = from[i] ? from[i] : currentOwner;
+        }
     }
+#endif
+    markTiles(tileVersions.data(), tileColumns, ++modCount, dstX, dstY, w, h);
+}
+
+// Recording clip: large enough to never clip, small enough that clip
+// arithmetic cannot overflow
+static const int RECORD_EXTENT = 1 << 28;
+
+void UnicodeBuffer::beginRecording(DisplayList& list) {
+    if (recorder) endRecording();
+    
+    list.clear();
+    recorder = &list;
+    recordBase = clipStack.size();
     
-    output << Color::RESET;
-    std::cout << output.str() << std::flush;
+    ClipState state;
+    state.clip = Rect(-RECORD_EXTENT, -RECORD_EXTENT, 2 * RECORD_EXTENT, 2 * RECORD_EXTENT);
+    state.dx = 0;
+    state.dy = 0;
+    clipStack.push_back(state);
+}
+
+void UnicodeBuffer::endRecording() {
+    if (!recorder) return;
+    // Also drops anything left pushed while recording
+    clipStack.resize(recordBase);
+    recorder = nullptr;
 }
 
+void UnicodeBuffer::replay(const DisplayList& list) {
+    if (recorder || list.empty()) return;
+    
+    const StyleId* styleMap = list.styleMap(*this);
+    CellTarget t = target();
+    const Rect clip = t.clip;
+    
+    for (const DisplayList::Command& command : list.getCommands()) {
+        // Skip commands that land entirely outside the current clip
+        Rect extent(command.extent.x + t.dx, command.extent.y + t.dy, command.extent.w, command.extent.h);
+        if (extent.intersect(clip).empty()) continue;
+        
+        t.clip = Rect(command.clip.x + t.dx, command.clip.y + t.dy, command.clip.w, command.clip.h).intersect(clip);
+        int x = command.x + t.dx;
+        int y = command.y + t.dy;
+        StyleId style = styleMap[command.style];
+        
+        switch (command.op) {
+            case DisplayList::OP_CELL:
+                putCell(t, x, y, command.glyph, style);
+                break;
+            case DisplayList::OP_HLINE:
+                putHLine(t, x, y, command.w, command.glyph, style);
+                break;
+            case DisplayList::OP_VLINE:
+                putVLine(t, x, y, command.h, command.glyph, style);
+                break;
+            case DisplayList::OP_TEXT:
+                putText(t, x, y, list.text(command), command.textLength, style, command.w + t.dx);
+                break;
+            case DisplayList::OP_RECT:
+                putRect(t, x, y, command.w, command.h, command.glyph, style);
+                break;
+            case DisplayList::OP_BOX:
+                putBox(t, x, y, command.w, command.h, style,
+                       (command.flags & DisplayList::BOX_ROUNDED) != 0, (command.flags & DisplayList::BOX_HEAVY) != 0);
+                break;
+        }
+    }
+}
@@ -3,6 +3,10 @@
 #include "../include/colors.h"
 #include <algorithm>
 
+ButtonEvent::ButtonEvent(EventType type, std::shared_ptr<Button> button)
+    : Event(type), button(button), buttonX(0), buttonY(0), toggleState(false) {
+}
+
 Button::Button(int x, int y, int w, int h, const std::string& text, 
                std::shared_ptr<Window> parent, ButtonType type)
     : x(x), y(y), w(w), h(h), text(text), type(type), state(ButtonState::NORMAL),
@@ -38,19 +42,25 @@ Button::Button(int x, int y, int w, int h, const std::string& text,
     }
 }
 
+// Buttons are rasterized into their window's cached layer, so any visible
+// change has to repaint it
+static void invalidateParentLayer(const std::weak_ptr<Window>& parentWindow) {
+    if (auto parent = parentWindow.lock()) {
+        parent->invalidate();
+    }
+}
+
 void Button::draw(UnicodeBuffer& buffer) {
     // Only draw if we have a valid parent window
     auto parent = parentWindow.lock();
     if (!parent || !parent->isVisible()) return;
     
-    // Get absolute position relative to screen
-    int absX = getAbsoluteX();
-    int absY = getAbsoluteY();
-    
-    // Check if button is within parent window bounds
-    if (absX + w > parent->x + parent->w - 1 || absY + h > parent->y + parent->h - 1) {
-        return; // Button extends outside parent window
-    }
+    // Clip to the parent's content area; a button that overflows it is
+    // drawn partially instead of not at all. The parts below draw in
+    // button-local coordinates.
+    buffer.pushClip(Rect(parent->getContentX(), parent->getContentY(),
+                         parent->getContentWidth(), parent->getContentHeight()));
+    buffer.pushTranslation(getAbsoluteX(), getAbsoluteY());
     
     // Draw shadow first (bottom-right offset by 1)
     if (showShadow && !isPressed()) {
@@ -62,6 +72,9 @@ void Button::draw(UnicodeBuffer& buffer) {
     
     // Draw text content
     drawText(buffer);
+    
+    buffer.pop();
+    buffer.pop();
 }
 
 void Button::updateMouse(FastMouseHandler& mouse) {
@@ -75,6 +88,8 @@ void Button::updateMouse(FastMouseHandler& mouse) {
     int mouseY = mouse.getMouseY();
     bool leftPressed = mouse.isLeftButtonPressed();
     bool mouseOver = contains(mouseX, mouseY);
+    ButtonState oldState = state;
+    bool oldToggled = toggled;
     
     // Generate mouse enter/leave events
     generateMouseEvents(mouse);
@@ -118,6 +133,10 @@ void Button::updateMouse(FastMouseHandler& mouse) {
         updateState(mouseOver, leftPressed && mouseOver);
     }
     
+    if (state != oldState || toggled != oldToggled) {
+        invalidateParentLayer(parentWindow);
+    }
+    
     wasLeftPressed = leftPressed;
 }
 
@@ -141,31 +160,15 @@ void Button::updateState(bool mouseOver, bool mousePressed) {
 void Button::drawShadow(UnicodeBuffer& buffer) {
     if (!showShadow) return;
     
-    int absX = getAbsoluteX();
-    int absY = getAbsoluteY();
-    
     // Draw shadow with offset (bottom and right edges)
     std::string shadowColorStr = shadowColor + Color::BG_BLACK;
     
-    // Right edge shadow
-    for (int row = 1; row <= h; row++) {
-        if (absY + row < absY + h + 1) {
-            buffer.setCell(absX + w, absY + row, Unicode::MEDIUM_SHADE, shadowColorStr);
-        }
-    }
-    
-    // Bottom edge shadow  
-    for (int col = 1; col <= w; col++) {
-        if (absX + col < absX + w + 1) {
-            buffer.setCell(absX + col, absY + h, Unicode::MEDIUM_SHADE, shadowColorStr);
-        }
-    }
+    // Right edge shadow (including the corner), then the bottom edge
+    buffer.drawVLine(w, 1, h, Unicode::MEDIUM_SHADE, shadowColorStr);
+    buffer.drawHLine(1, h, w - 1, Unicode::MEDIUM_SHADE, shadowColorStr);
 }
 
 void Button::drawBackground(UnicodeBuffer& buffer) {
-    int absX = getAbsoluteX();
-    int absY = getAbsoluteY();
-    
     // Get current background color based on state
     std::string bgColor = getCurrentBackgroundColor();
     
@@ -174,17 +177,10 @@ void Button::drawBackground(UnicodeBuffer& buffer) {
     int offsetY = isPressed() ? 1 : 0;
     
     // Draw button background
-    for (int row = 0; row < h; row++) {
-        for (int col = 0; col < w; col++) {
-            buffer.setCell(absX + col + offsetX, absY + row + offsetY, " ", bgColor);
-        }
-    }
+    buffer.fillRect(offsetX, offsetY, w, h, " ", bgColor);
 }
 
 void Button::drawText(UnicodeBuffer& buffer) {
-    int absX = getAbsoluteX();
-    int absY = getAbsoluteY();
-    
     std::string displayText = getDisplayText();
     
     // Adjust position for pressed state
@@ -192,21 +188,21 @@ void Button::drawText(UnicodeBuffer& buffer) {
     int offsetY = isPressed() ? 1 : 0;
     
     // Calculate text position (centered)
-    int textX = absX + offsetX + (w - (int)displayText.length()) / 2;
-    int textY = absY + offsetY + h / 2;
+    int textX = offsetX + (w - (int)displayText.length()) / 2;
+    int textY = offsetY + h / 2;
     
     // Ensure text fits within button bounds
-    textX = std::max(absX + offsetX, textX);
-    textX = std::min(absX + offsetX + w - (int)displayText.length(), textX);
-    textY = std::max(absY + offsetY, textY);
-    textY = std::min(absY + offsetY + h, textY);
+    textX = std::max(offsetX, textX);
+    textX = std::min(offsetX + w - (int)displayText.length(), textX);
+    textY = std::max(offsetY, textY);
+    textY = std::min(offsetY + h, textY);
     
     // Get text and background colors
     std::string txtColor = getCurrentTextColor();
     std::string bgColor = getCurrentBackgroundColor();
     
     // Draw the text
-    buffer.drawStringClipped(textX, textY, displayText, txtColor + bgColor, absX + offsetX + w);
+    buffer.drawStringClipped(textX, textY, displayText, txtColor + bgColor, offsetX + w);
 }
 
 std::string Button::getDisplayText() const {
@@ -301,6 +297,7 @@ void Button::setEnabled(bool newEnabled) {
     if (!enabled) {
         state = ButtonState::NORMAL;
     }
+    invalidateParentLayer(parentWindow);
 }
 
 void Button::setToggled(bool newToggled) {
@@ -308,29 +305,33 @@ void Button::setToggled(bool newToggled) {
         toggled = newToggled;
         state = toggled ? ButtonState::TOGGLED_ON : ButtonState::NORMAL;
     }
+    invalidateParentLayer(parentWindow);
 }
 
 void Button::setText(const std::string& newText) {
     text = newText;
+    invalidateParentLayer(parentWindow);
 }
 
 void Button::setPosition(int newX, int newY) {
     x = newX;
     y = newY;
+    invalidateParentLayer(parentWindow);
 }
 
 void Button::setSize(int newW, int newH) {
     w = std::max(3, newW); // Minimum width for usability
     h = std::max(1, newH); // Minimum height for usability
+    invalidateParentLayer(parentWindow);
 }
 
 // Event handler setters
 void Button::setOnClick(std::function<void()> callback) {
-    onClick = callback;
+    onClick = std::move(callback);
 }
 
 void Button::setOnToggle(std::function<void(bool)> callback) {
-    onToggle = callback;
+    onToggle = std::move(callback);
 }
 
 // Parent window management
@@ -352,11 +353,13 @@ void Button::setColors(const std::string& text, const std::string& background,
     pressedColor = pressed;
     if (!disabled.empty()) disabledColor = disabled;
     if (!toggledOn.empty()) toggledColor = toggledOn;
+    invalidateParentLayer(parentWindow);
 }
 
 void Button::setShadow(const std::string& shadowColorStr, bool enable) {
     shadowColor = shadowColorStr;
     showShadow = enable;
+    invalidateParentLayer(parentWindow);
 }
 
 // Event generation methods
@@ -13,8 +13,8 @@ Checkbox::Checkbox(std::shared_ptr<Window> parent, int x, int y, const std::stri
       visible(true), active(false), enabled(true),
       checkedChar("✓"), uncheckedChar(" "),
       boxColor(Color::WHITE + Color::BG_BLACK), labelColor(Color::BRIGHT_WHITE + Color::BG_BLACK),
-      activeColor(Color::BLACK + Color::BG_BRIGHT_WHITE), disabledColor(Color::CYAN + Color::BG_BLACK),
-      wasLeftPressed(false) {
+      activeColor(Color::BLACK + Color::BG_BRIGHT_WHITE), disabledColor(Color::CYAN + Color::BG_BLACK) {
+    pointer.attach(parent ? parent->id : 0, [this](const MouseEvent& event) { handlePointer(event); });
     calculateDimensions();
 }
 
@@ -22,6 +22,12 @@ void Checkbox::calculateDimensions() {
     // Width: [X] + space + label
     width = 4 + (int)label.length(); // [X] label
     height = 1;
+    placePointerTarget();
+}
+
+void Checkbox::placePointerTarget() {
+    bool hittable = visible && enabled;
+    pointer.place(hittable ? Rect(x, y, width, height) : Rect());
 }
 
 void Checkbox::setChecked(bool state) {
@@ -50,6 +56,7 @@ void Checkbox::setEnabled(bool state) {
     if (!enabled) {
         active = false;
     }
+    placePointerTarget();
 }
 
 void Checkbox::setLabel(const std::string& newLabel) {
@@ -73,39 +80,23 @@ bool Checkbox::contains(int mx, int my) const {
     return mx >= absX && mx < absX + width && my >= absY && my < absY + height;
 }
 
-void Checkbox::updateMouse(FastMouseHandler& mouse, int termWidth, int termHeight) {
-    if (!visible || !enabled || !parentWindow || !parentWindow->isVisible()) return;
-    
-    int mouseX = mouse.getMouseX();
-    int mouseY = mouse.getMouseY();
-    bool leftPressed = mouse.isLeftButtonPressed();
-    
-    bool isHovering = contains(mouseX, mouseY);
-    bool wasHovering = active;
-    active = isHovering;
-    
-    // Generate hover/leave events
-    if (isHovering && !wasHovering && onHover) {
-        auto event = MouseEvent(EventType::MOUSE_ENTER, mouseX, mouseY);
-        onHover(event);
-    } else if (!isHovering && wasHovering && onLeave) {
-        auto event = MouseEvent(EventType::MOUSE_LEAVE, mouseX, mouseY);
-        onLeave(event);
-    }
-    
-    if (isHovering) {
-        // Handle click events
-        if (leftPressed && !wasLeftPressed) {
+void Checkbox::handlePointer(const MouseEvent& event) {
+    switch (event.type) {
+        case EventType::MOUSE_ENTER:
+            active = true;
+            if (onHover) onHover(event);
+            break;
+        case EventType::MOUSE_LEAVE:
+            active = false;
+            if (onLeave) onLeave(event);
+            break;
+        case EventType::MOUSE_PRESS:
             toggle();
-            
-            if (onClick) {
-                auto event = MouseEvent(EventType::MOUSE_PRESS, mouseX, mouseY);
-                onClick(event);
-            }
-        }
+            if (onClick) onClick(event);
+            break;
+        default:
+            break;
     }
-    
-    wasLeftPressed = leftPressed;
 }
 
 void Checkbox::draw(UnicodeBuffer& buffer) {
@@ -0,0 +1,287 @@
+#include "../include/display_list.h"
+#include "../include/colors.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+static const char MAGIC[4] = { 'T', 'D', 'L', '1' };
+
+void DisplayList::clear() {
+    commands.clear();
+    textPool.clear();
+    styles.clear();
+    styleLookup.clear();
+    mappedStyles.clear();
+    mapTarget = 0;
+    
+    // Style 0 is reset, matching UnicodeBuffer
+    styles.push_back(Color::RESET);
+    styleLookup[Color::RESET] = 0;
+}
+
+uint16_t DisplayList::internStyle(const std::string& color) {
+    auto it = styleLookup.find(color);
+    if (it != styleLookup.end()) return it->second;
+    if (styles.size() > 0xFFFF) return 0;
+    
+    uint16_t id = (uint16_t)styles.size();
+    styles.push_back(color);
+    styleLookup[color] = id;
+    return id;
+}
+
+void DisplayList::add(Command& command, const std::string& color) {
+    // Fully clipped calls draw nothing and are dropped
+    if (command.extent.empty()) return;
+    command.style = internStyle(color);
+    commands.push_back(command);
+}
+
+static DisplayList::Command makeCommand(DisplayList::Op op, const Rect& clip, int x, int y, int w, int h, uint32_t glyph) {
+    DisplayList::Command command;
+    command.op = op;
+    command.flags = 0;
+    command.style = 0;
+    command.x = x;
+    command.y = y;
+    command.w = w;
+    command.h = h;
+    command.glyph = glyph;
+    command.textOffset = 0;
+    command.textLength = 0;
+    command.clip = clip;
+    return command;
+}
+
+void DisplayList::recordCell(const Rect& clip, int x, int y, uint32_t glyph, const std::string& color) {
+    Command command = makeCommand(OP_CELL, clip, x, y, 1, 1, glyph);
+    command.extent = Rect(x, y, 1, 1).intersect(clip);
+    add(command, color);
+}
+
+void DisplayList::recordHLine(const Rect& clip, int x, int y, int length, uint32_t glyph, const std::string& color) {
+    Command command = makeCommand(OP_HLINE, clip, x, y, length, 1, glyph);
+    command.extent = Rect(x, y, length, 1).intersect(clip);
+    add(command, color);
+}
+
+void DisplayList::recordVLine(const Rect& clip, int x, int y, int length, uint32_t glyph, const std::string& color) {
+    Command command = makeCommand(OP_VLINE, clip, x, y, 1, length, glyph);
+    command.extent = Rect(x, y, 1, length).intersect(clip);
+    add(command, color);
+}
+
+void DisplayList::recordText(const Rect& clip, int x, int y, const std::string& text, const std::string& color, int limitX) {
+    Command command = makeCommand(OP_TEXT, clip, x, y, limitX, 1, 0);
+    int columns = std::min(UnicodeUtils::getDisplayWidth(text), limitX - x);
+    command.extent = Rect(x, y, columns, 1).intersect(clip);
+    command.textOffset = (uint32_t)textPool.size();
+    command.textLength = (uint32_t)text.size();
+    if (!command.extent.empty()) {
+        textPool.append(text);
+    }
+    add(command, color);
+}
+
+void DisplayList::recordRect(const Rect& clip, int x, int y, int w, int h, uint32_t glyph, const std::string& color) {
+    Command command = makeCommand(OP_RECT, clip, x, y, w, h, glyph);
+    command.extent = Rect(x, y, w, h).intersect(clip);
+    add(command, color);
+}
+
+void DisplayList::recordBox(const Rect& clip, int x, int y, int w, int h, const std::string& color, bool rounded, bool heavy) {
+    Command command = makeCommand(OP_BOX, clip, x, y, w, h, 0);
+    command.flags = (rounded ? BOX_ROUNDED : 0) | (heavy ? BOX_HEAVY : 0);
+    // Degenerate boxes still plot their corners at x and x + w - 1
+    int x0 = std::min(x, x + w - 1);
+    int y0 = std::min(y, y + h - 1);
+    command.extent = Rect(x0, y0, std::abs(w - 1) + 1, std::abs(h - 1) + 1).intersect(clip);
+    add(command, color);
+}
+
+Rect DisplayList::getBounds() const {
+    if (commands.empty()) return Rect();
+    
+    int x0 = commands[0].extent.x;
+    int y0 = commands[0].extent.y;
+    int x1 = x0 + commands[0].extent.w;
+    int y1 = y0 + commands[0].extent.h;
+    for (const Command& command : commands) {
+        const Rect& e = command.extent;
+        x0 = std::min(x0, e.x);
+        y0 = std::min(y0, e.y);
+        x1 = std::max(x1, e.x + e.w);
+        y1 = std::max(y1, e.y + e.h);
+    }
+    return Rect(x0, y0, x1 - x0, y1 - y0);
+}
+
+const StyleId* DisplayList::styleMap(UnicodeBuffer& buffer) const {
+    if (mapTarget != buffer.getInstanceId()) {
+        mappedStyles.clear();
+        mapTarget = buffer.getInstanceId();
+    }
+    while (mappedStyles.size() < styles.size()) {
+        mappedStyles.push_back(buffer.internStyle(styles[mappedStyles.size()]));
+    }
+    return mappedStyles.data();
+}
+
+bool DisplayList::sameCommand(const Command& a, const DisplayList& other, const Command& b) const {
+    if (a.op != b.op || a.flags != b.flags || a.x != b.x || a.y != b.y || a.w != b.w || a.h != b.h ||
+        a.glyph != b.glyph || a.clip != b.clip || a.textLength != b.textLength) {
+        return false;
+    }
+    if (styles[a.style] != other.styles[b.style]) return false;
+    return memcmp(text(a), other.text(b), a.textLength) == 0;
+}
+
+void DisplayList::diff(const DisplayList& before, const DisplayList& after, std::vector<Rect>& out) {
+    const std::vector<Command>& a = before.commands;
+    const std::vector<Command>& b = after.commands;
+    
+    // Widgets redraw in the same order each time, so the changes are
+    // usually one contiguous stretch between a common prefix and suffix
+    size_t prefix = 0;
+    while (prefix < a.size() && prefix < b.size() && before.sameCommand(a[prefix], after, b[prefix])) {
+        prefix++;
+    }
+    size_t suffix = 0;
+    while (suffix < a.size() - prefix && suffix < b.size() - prefix &&
+           before.sameCommand(a[a.size() - 1 - suffix], after, b[b.size() - 1 - suffix])) {
+        suffix++;
+    }
+    
+    for (size_t i = prefix; i < a.size() - suffix; i++) {
+        out.push_back(a[i].extent);
+    }
+    for (size_t i = prefix; i < b.size() - suffix; i++) {
+        out.push_back(b[i].extent);
+    }
+}
+
+static void putU32(std::string& out, uint32_t value) {
+    char bytes[4] = { (char)value, (char)(value >> 8), (char)(value >> 16), (char)(value >> 24) };
+    out.append(bytes, 4);
+}
+
+static void putRect(std::string& out, const Rect& r) {
+    putU32(out, (uint32_t)r.x);
+    putU32(out, (uint32_t)r.y);
+    putU32(out, (uint32_t)r.w);
+    putU32(out, (uint32_t)r.h);
+}
+
+void DisplayList::serialize(std::string& out) const {
+    out.append(MAGIC, 4);
+    
+    putU32(out, (uint32_t)styles.size());
+    for (const std::string& style : styles) {
+        putU32(out, (uint32_t)style.size());
+        out.append(style);
+    }
+    putU32(out, (uint32_t)textPool.size());
+    out.append(textPool);
+    
+    putU32(out, (uint32_t)commands.size());
+    for (const Command& command : commands) {
+        putU32(out, command.op | (uint32_t)command.flags << 8 | (uint32_t)command.style << 16);
+        putU32(out, (uint32_t)command.x);
+        putU32(out, (uint32_t)command.y);
+        putU32(out, (uint32_t)command.w);
+        putU32(out, (uint32_t)command.h);
+        putU32(out, command.glyph);
+        putU32(out, command.textOffset);
+        putU32(out, command.textLength);
+        putRect(out, command.clip);
+        putRect(out, command.extent);
+    }
+}
+
+namespace {
+
+// Bounds-checked reader over serialized bytes
+struct Reader {
+    const unsigned char* p;
+    size_t remaining;
+    bool ok;
+    
+    uint32_t u32() {
+        if (remaining < 4) { ok = false; return 0; }
+        uint32_t value = p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+        p += 4;
+        remaining -= 4;
+        return value;
+    }
+    
+    bool bytes(std::string& out, size_t n) {
+        if (remaining < n) { ok = false; return false; }
+        out.assign((const char*)p, n);
+        p += n;
+        remaining -= n;
+        return true;
+    }
+    
+    Rect rect() {
+        int x = (int)u32();
+        int y = (int)u32();
+        int w = (int)u32();
+        int h = (int)u32();
+        return Rect(x, y, w, h);
+    }
+};
+
+}
+
+bool DisplayList::deserialize(const char* data, size_t size) {
+    clear();
+    if (size < 4 || memcmp(data, MAGIC, 4) != 0) return false;
+    
+    Reader in = { (const unsigned char*)data + 4, size - 4, true };
+    
+    uint32_t styleCount = in.u32();
+    if (styleCount == 0 || styleCount > 0x10000) return false;
+    styles.clear();
+    styleLookup.clear();
+    for (uint32_t i = 0; i < styleCount && in.ok; i++) {
+        std::string style;
+        in.bytes(style, in.u32());
+        styleLookup[style] = (uint16_t)styles.size();
+        styles.push_back(style);
+    }
+    in.bytes(textPool, in.u32());
+    
+    uint32_t count = in.u32();
+    // Each command is 64 bytes; reject counts the data cannot hold
+    if (!in.ok || count > in.remaining / 64) {
+        clear();
+        return false;
+    }
+    commands.resize(count);
+    for (Command& command : commands) {
+        uint32_t header = in.u32();
+        command.op = (Op)(header & 0xFF);
+        command.flags = (uint8_t)(header >> 8);
+        command.style = (uint16_t)(header >> 16);
+        command.x = (int)in.u32();
+        command.y = (int)in.u32();
+        command.w = (int)in.u32();
+        command.h = (int)in.u32();
+        command.glyph = in.u32();
+        command.textOffset = in.u32();
+        command.textLength = in.u32();
+        command.clip = in.rect();
+        command.extent = in.rect();
+        
+        if (command.op > OP_BOX || command.style >= styles.size() ||
+            command.textOffset > textPool.size() || command.textLength > textPool.size() - command.textOffset) {
+            in.ok = false;
+        }
+    }
+    
+    if (!in.ok || in.remaining != 0) {
+        clear();
+        return false;
+    }
+    return true;
+}
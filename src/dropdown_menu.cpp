@@ -3,8 +3,18 @@
 #include <algorithm>
 #include <memory>
 
+MenuEvent::MenuEvent(EventType type, std::shared_ptr<DropdownMenu> menu, const std::string& title)
+    : Event(type), menu(menu), menuTitle(title), itemIndex(-1), mouseX(0), mouseY(0) {
+}
+
+MenuEvent::MenuEvent(EventType type, std::shared_ptr<DropdownMenu> menu, const std::string& title,
+                     int itemIndex, const std::string& itemText, const std::string& itemShortcut)
+    : Event(type), menu(menu), menuTitle(title), itemIndex(itemIndex), itemText(itemText),
+      itemShortcut(itemShortcut), mouseX(0), mouseY(0) {
+}
+
 DropdownMenu::DropdownMenu(int x, int y, const std::string& title)
-    : x(x), y(y), title(title), visible(true), active(false), 
+    : id(UnicodeBuffer::allocateOwnerId()), x(x), y(y), title(title), visible(true), active(false), 
       selectedIndex(-1), wasLeftPressed(false), menuOpen(false),
       lastHoveredIndex(-1), wasMenuOpen(false), isApplicationMenuBar(false), menuBarWidth(0) {
     calculateDimensions();
@@ -68,9 +78,7 @@ void DropdownMenu::drawTrigger(UnicodeBuffer& buffer) {
         // First, fill the trigger area with the menu bar background if not active
         if (!active) {
             std::string menuBarColor = Color::BRIGHT_WHITE + Color::BG_BLACK;
-            for (int i = 0; i < triggerWidth; i++) {
-                buffer.setCell(triggerX + i, triggerY, " ", menuBarColor);
-            }
+            buffer.drawHLine(triggerX, triggerY, triggerWidth, " ", menuBarColor);
             triggerColor = menuBarColor; // Use menu bar colors for non-active state
         }
     }
@@ -90,11 +98,7 @@ void DropdownMenu::drawMenu(UnicodeBuffer& buffer) {
     int menuY = triggerY + 1;
     
     // Fill entire menu area with background color first
-    for (int row = 0; row < height; row++) {
-        for (int col = 0; col < width; col++) {
-            buffer.setCell(x + col, menuY + row, " ", bgColor);
-        }
-    }
+    buffer.fillRect(x, menuY, width, height, " ", bgColor);
     
     // Draw menu border using single-line box drawing over the background
     buffer.drawBox(x, menuY, width, height, borderColor, true, false);
@@ -106,9 +110,7 @@ void DropdownMenu::drawMenu(UnicodeBuffer& buffer) {
         
         if (item.separator) {
             // Draw separator line
-            for (int col = 1; col < width - 1; col++) {
-                buffer.setCell(x + col, itemY, Unicode::HORIZONTAL, borderColor);
-            }
+            buffer.drawHLine(x + 1, itemY, width - 2, Unicode::HORIZONTAL, borderColor);
         } else {
             // Determine text color
             std::string textColor = bgColor;
@@ -121,9 +123,7 @@ void DropdownMenu::drawMenu(UnicodeBuffer& buffer) {
             // Draw highlighted background for content area (excluding borders)
             if (i == selectedIndex && item.enabled) {
                 // Highlight the content area between borders (x+1 to x+width-2)
-                for (int col = 1; col < width - 1; col++) {
-                    buffer.setCell(x + col, itemY, " ", selectedColor);
-                }
+                buffer.drawHLine(x + 1, itemY, width - 2, " ", selectedColor);
             }
             
             // Draw item text
@@ -153,8 +153,11 @@ void DropdownMenu::draw(UnicodeBuffer& buffer) {
     // Note: Application menu bar background is now drawn by drawApplicationMenuBars()
     // for efficiency, so we don't draw it here individually
     
+    uint32_t previousOwner = buffer.getOwner();
+    buffer.setOwner(id);
     drawTrigger(buffer);
     drawMenu(buffer);
+    buffer.setOwner(previousOwner);
 }
 
 void DropdownMenu::drawApplicationMenuBar(UnicodeBuffer& buffer) {
@@ -163,9 +166,7 @@ void DropdownMenu::drawApplicationMenuBar(UnicodeBuffer& buffer) {
     std::string barColor = Color::BRIGHT_WHITE + Color::BG_BLACK;
     
     // Draw horizontal menu bar background across the specified width
-    for (int i = 0; i < menuBarWidth; i++) {
-        buffer.setCell(i, triggerY, " ", barColor);
-    }
+    buffer.drawHLine(0, triggerY, menuBarWidth, " ", barColor);
 }
 
 bool DropdownMenu::triggerContains(int mx, int my) const {
@@ -288,9 +289,7 @@ void DropdownMenu::drawMenuBar(UnicodeBuffer& buffer, int y, int termWidth) {
     std::string barColor = Color::BRIGHT_WHITE + Color::BG_BLACK;
     
     // Draw horizontal menu bar background across entire screen
-    for (int x = 0; x < termWidth; x++) {
-        buffer.setCell(x, y, " ", barColor);
-    }
+    buffer.drawHLine(0, y, termWidth, " ", barColor);
 }
 
 // Static utility for setting up application menu bars
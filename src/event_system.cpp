@@ -0,0 +1,143 @@
+#include "../include/event_system.h"
+#include <algorithm>
+
+// Initial queue capacity; a frame rarely carries more input than this
+static const size_t INITIAL_QUEUE_SIZE = 64;
+
+EventManager::EventManager()
+    : nextSerial(1), dispatchDepth(0), removedDuringDispatch(false), queue(INITIAL_QUEUE_SIZE), queueHead(0), queueCount(0) {}
+
+EventManager& EventManager::getInstance() {
+    static EventManager instance;
+    return instance;
+}
+
+EventManager::ListenerId EventManager::subscribe(EventType type, Listener listener) {
+    if (type >= EventType::COUNT || !listener) return 0;
+    
+    Entry entry;
+    entry.id = nextSerial++ << 8 | (ListenerId)type;
+    entry.listener = std::move(listener);
+    ListenerId id = entry.id;
+    
+    // The arrays being walked must not reallocate under a dispatch
+    if (dispatchDepth > 0) {
+        added.push_back(std::move(entry));
+    } else {
+        listeners[(size_t)type].push_back(std::move(entry));
+    }
+    return id;
+}
+
+void EventManager::unsubscribe(ListenerId id) {
+    if (id == 0 || (id & 0xFF) >= (ListenerId)EventType::COUNT) return;
+    
+    std::vector<Entry>& list = listeners[id & 0xFF];
+    for (size_t i = 0; i < list.size(); i++) {
+        if (list[i].id != id) continue;
+        if (dispatchDepth > 0) {
+            // The listener may be the one running; keep it alive until
+            // the dispatch ends
+            list[i].id = 0;
+            removedDuringDispatch = true;
+        } else {
+            list.erase(list.begin() + i);
+        }
+        return;
+    }
+    for (size_t i = 0; i < added.size(); i++) {
+        if (added[i].id == id) {
+            added.erase(added.begin() + i);
+            return;
+        }
+    }
+}
+
+size_t EventManager::getListenerCount(EventType type) const {
+    if (type >= EventType::COUNT) return 0;
+    
+    const std::vector<Entry>& list = listeners[(size_t)type];
+    size_t count = 0;
+    for (const Entry& entry : list) {
+        count += entry.id != 0;
+    }
+    for (const Entry& entry : added) {
+        count += (entry.id & 0xFF) == (ListenerId)type;
+    }
+    return count;
+}
+
+void EventManager::dispatch(const Event& event) {
+    if (event.type >= EventType::COUNT) return;
+    
+    std::vector<Entry>& list = listeners[(size_t)event.type];
+    dispatchDepth++;
+    for (size_t i = 0, count = list.size(); i < count; i++) {
+        if (list[i].id != 0) {
+            list[i].listener(event);
+        }
+    }
+    dispatchDepth--;
+    
+    if (dispatchDepth == 0 && (removedDuringDispatch || !added.empty())) {
+        flushPendingChanges();
+    }
+}
+
+void EventManager::flushPendingChanges() {
+    if (removedDuringDispatch) {
+        for (std::vector<Entry>& list : listeners) {
+            list.erase(std::remove_if(list.begin(), list.end(), [](const Entry& entry) { return entry.id == 0; }),
+                       list.end());
+        }
+        removedDuringDispatch = false;
+    }
+    for (Entry& entry : added) {
+        listeners[entry.id & 0xFF].push_back(std::move(entry));
+    }
+    added.clear();
+}
+
+EventManager::QueuedEvent& EventManager::pushSlot() {
+    if (queueCount == queue.size()) {
+        // Unroll the ring into a larger one
+        std::vector<QueuedEvent> larger(queue.size() * 2);
+        for (size_t i = 0; i < queueCount; i++) {
+            larger[i] = queue[(queueHead + i) & (queue.size() - 1)];
+        }
+        queue.swap(larger);
+        queueHead = 0;
+    }
+    
+    QueuedEvent& slot = queue[(queueHead + queueCount) & (queue.size() - 1)];
+    queueCount++;
+    return slot;
+}
+
+void EventManager::post(const MouseEvent& event) {
+    QueuedEvent& slot = pushSlot();
+    slot.kind = QueuedEvent::MOUSE;
+    slot.mouse = event;
+}
+
+void EventManager::post(const KeyboardEvent& event) {
+    QueuedEvent& slot = pushSlot();
+    slot.kind = QueuedEvent::KEYBOARD;
+    slot.keyboard = event;
+}
+
+size_t EventManager::processQueue() {
+    size_t count = queueCount;
+    for (size_t i = 0; i < count; i++) {
+        // Copy the slot out first: a listener may post and grow the ring
+        QueuedEvent slot = queue[queueHead];
+        queueHead = (queueHead + 1) & (queue.size() - 1);
+        queueCount--;
+        if (slot.kind == QueuedEvent::MOUSE) {
+            dispatch(slot.mouse);
+        } else {
+            dispatch(slot.keyboard);
+        }
+    }
+    return count;
+}
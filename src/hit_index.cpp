@@ -0,0 +1,112 @@
+#include "../include/hit_index.h"
+#include <algorithm>
+
+void HitIndex::resize(int w, int h) {
+    width = std::max(0, w);
+    height = std::max(0, h);
+    columns = (width + BUCKET_WIDTH - 1) / BUCKET_WIDTH;
+    rows = (height + BUCKET_HEIGHT - 1) / BUCKET_HEIGHT;
+    
+    buckets.assign((size_t)columns * rows, std::vector<uint32_t>());
+    for (const auto& entry : slots) {
+        link(entry.second);
+    }
+}
+
+void HitIndex::clear() {
+    targets.clear();
+    slots.clear();
+    freeSlots.clear();
+    for (std::vector<uint32_t>& bucket : buckets) {
+        bucket.clear();
+    }
+}
+
+bool HitIndex::above(uint32_t a, uint32_t b) const {
+    const Target& ta = targets[a];
+    const Target& tb = targets[b];
+    return ta.depth != tb.depth ? ta.depth > tb.depth : ta.sequence > tb.sequence;
+}
+
+// Range of buckets a rect overlaps, as a rect in bucket coordinates
+Rect HitIndex::bucketRange(const Rect& rect) const {
+    Rect clipped = rect.intersect(Rect(0, 0, width, height));
+    if (clipped.empty()) return Rect();
+    int bx0 = clipped.x / BUCKET_WIDTH;
+    int by0 = clipped.y / BUCKET_HEIGHT;
+    int bx1 = (clipped.x + clipped.w - 1) / BUCKET_WIDTH;
+    int by1 = (clipped.y + clipped.h - 1) / BUCKET_HEIGHT;
+    return Rect(bx0, by0, bx1 - bx0 + 1, by1 - by0 + 1);
+}
+
+void HitIndex::link(uint32_t slot) {
+    Rect range = bucketRange(targets[slot].rect);
+    for (int by = range.y; by < range.y + range.h; by++) {
+        for (int bx = range.x; bx < range.x + range.w; bx++) {
+            std::vector<uint32_t>& bucket = buckets[(size_t)by * columns + bx];
+            auto it = std::lower_bound(bucket.begin(), bucket.end(), slot,
+                                       [this](uint32_t a, uint32_t b) { return above(a, b); });
+            bucket.insert(it, slot);
+        }
+    }
+}
+
+void HitIndex::unlink(uint32_t slot) {
+    Rect range = bucketRange(targets[slot].rect);
+    for (int by = range.y; by < range.y + range.h; by++) {
+        for (int bx = range.x; bx < range.x + range.w; bx++) {
+            std::vector<uint32_t>& bucket = buckets[(size_t)by * columns + bx];
+            bucket.erase(std::find(bucket.begin(), bucket.end(), slot));
+        }
+    }
+}
+
+void HitIndex::set(uint32_t id, const Rect& rect, uint32_t depth) {
+    if (id == 0) return;
+    if (rect.empty()) {
+        remove(id);
+        return;
+    }
+    
+    auto it = slots.find(id);
+    uint32_t slot;
+    if (it != slots.end()) {
+        slot = it->second;
+        Target& target = targets[slot];
+        if (target.rect == rect && target.depth == depth) return;
+        unlink(slot);
+    } else if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        slots[id] = slot;
+    } else {
+        slot = (uint32_t)targets.size();
+        targets.push_back(Target());
+        slots[id] = slot;
+    }
+    
+    Target& target = targets[slot];
+    target.id = id;
+    target.depth = depth;
+    target.sequence = ++sequence;
+    target.rect = rect;
+    link(slot);
+}
+
+void HitIndex::remove(uint32_t id) {
+    auto it = slots.find(id);
+    if (it == slots.end()) return;
+    unlink(it->second);
+    freeSlots.push_back(it->second);
+    slots.erase(it);
+}
+
+uint32_t HitIndex::query(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) return 0;
+    
+    const std::vector<uint32_t>& bucket = buckets[(size_t)(y / BUCKET_HEIGHT) * columns + x / BUCKET_WIDTH];
+    for (uint32_t slot : bucket) {
+        if (targets[slot].rect.contains(x, y)) return targets[slot].id;
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include "../include/input_recorder.h"
+#include <algorithm>
+
+static const char MAGIC[4] = { 'T', 'U', 'I', 'R' };
+static const uint8_t VERSION = 1;
+static const uint8_t PRESS_BIT = 0x80;
+
+bool InputRecorder::open(const std::string& path) {
+    close();
+    file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    
+    fwrite(MAGIC, 1, sizeof(MAGIC), file);
+    fputc(VERSION, file);
+    start = ASMOptimized::monotonic_ns();
+    lastTime = 0;
+    return true;
+}
+
+void InputRecorder::close() {
+    if (!file) return;
+    fclose(file);
+    file = nullptr;
+}
+
+void InputRecorder::putVarint(uint64_t value) {
+    while (value >= 0x80) {
+        fputc((int)(value & 0x7f) | 0x80, file);
+        value >>= 7;
+    }
+    fputc((int)value, file);
+}
+
+void InputRecorder::begin(uint8_t kind) {
+    uint64_t now = (ASMOptimized::monotonic_ns() - start) / 1000;
+    fputc(kind, file);
+    putVarint(now - lastTime);
+    lastTime = now;
+}
+
+void InputRecorder::recordMouse(const ASMOptimized::SGRMouseEvent& event) {
+    if (!file) return;
+    begin(InputRecord::MOUSE | (event.press ? PRESS_BIT : 0));
+    putVarint((uint32_t)event.button);
+    putVarint((uint32_t)event.x);
+    putVarint((uint32_t)event.y);
+}
+
+void InputRecorder::recordResize(int width, int height) {
+    if (!file) return;
+    begin(InputRecord::RESIZE);
+    putVarint((uint32_t)width);
+    putVarint((uint32_t)height);
+}
+
+// Reads one varint at `pos`; false if the data ends inside it
+static bool getVarint(const std::vector<uint8_t>& data, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; pos < data.size() && shift < 64; shift += 7) {
+        uint8_t byte = data[pos++];
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+bool InputReplay::open(const std::string& path) {
+    records.clear();
+    position = 0;
+    
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t got;
+    while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + got);
+    }
+    fclose(file);
+    
+    if (data.size() < sizeof(MAGIC) + 1 || !std::equal(MAGIC, MAGIC + sizeof(MAGIC), data.begin()) ||
+        data[sizeof(MAGIC)] != VERSION) {
+        return false;
+    }
+    
+    // A record cut short by a crash ends the recording there
+    size_t pos = sizeof(MAGIC) + 1;
+    uint64_t time = 0;
+    while (pos < data.size()) {
+        uint8_t kind = data[pos++];
+        uint64_t delta, a, b, c = 0;
+        if (!getVarint(data, pos, delta) || !getVarint(data, pos, a) || !getVarint(data, pos, b)) break;
+        
+        InputRecord record;
+        time += delta;
+        record.time = time;
+        record.width = record.height = 0;
+        record.mouse = ASMOptimized::SGRMouseEvent();
+        if ((kind & ~PRESS_BIT) == InputRecord::MOUSE) {
+            if (!getVarint(data, pos, c)) break;
+            record.kind = InputRecord::MOUSE;
+            record.mouse.button = (int)a;
+            record.mouse.x = (int)b;
+            record.mouse.y = (int)c;
+            record.mouse.press = (kind & PRESS_BIT) != 0;
+        } else if (kind == InputRecord::RESIZE) {
+            record.kind = InputRecord::RESIZE;
+            record.width = (int)a;
+            record.height = (int)b;
+        } else {
+            return false;
+        }
+        records.push_back(record);
+    }
+    return true;
+}
+
+void InputReplay::start(bool realTimePacing, uint64_t frameInterval) {
+    position = 0;
+    clock = 0;
+    realTime = realTimePacing;
+    frameMicros = frameInterval;
+    startedAt = ASMOptimized::monotonic_ns();
+}
+
+void InputReplay::advance() {
+    if (realTime) {
+        clock = (ASMOptimized::monotonic_ns() - startedAt) / 1000;
+    } else {
+        clock += frameMicros;
+    }
+}
+
+const InputRecord* InputReplay::next() {
+    if (position >= records.size() || records[position].time > clock) return nullptr;
+    return &records[position++];
+}
@@ -21,7 +21,9 @@ ListBox::ListBox(std::shared_ptr<Window> parent, int x, int y, int width, int he
       activeColor(Color::BLACK + Color::BG_BRIGHT_WHITE), disabledColor(Color::CYAN + Color::BG_BLACK),
       separatorColor(Color::CYAN + Color::BG_BLACK),
       showScrollbar(true), scrollbarColor(Color::WHITE + Color::BG_CYAN), scrollThumbColor(Color::BLACK + Color::BG_BRIGHT_WHITE),
-      multiSelect(false), wasLeftPressed(false), hoveredIndex(-1), dragging(false) {
+      multiSelect(false), hoveredIndex(-1), dragging(false) {
+    pointer.attach(parent ? parent->id : 0, [this](const MouseEvent& event) { handlePointer(event); });
+    pointer.setScrollable(true);
     calculateDimensions();
 }
 
@@ -113,6 +115,11 @@ void ListBox::scrollDown() {
     }
 }
 
+void ListBox::scrollBy(int lines) {
+    int maxScroll = std::max(0, (int)items.size() - getVisibleItemCount());
+    scrollOffset = std::max(0, std::min(maxScroll, scrollOffset + lines));
+}
+
 void ListBox::ensureItemVisible(int index) {
     if (index < 0 || index >= (int)items.size()) return;
     
@@ -160,66 +167,71 @@ bool ListBox::contains(int mx, int my) const {
     return mx >= absX && mx < absX + width && my >= absY && my < absY + height;
 }
 
-void ListBox::updateMouse(FastMouseHandler& mouse, int termWidth, int termHeight) {
-    if (!visible || !enabled || !parentWindow || !parentWindow->isVisible()) return;
-    
-    int mouseX = mouse.getMouseX();
-    int mouseY = mouse.getMouseY();
-    bool leftPressed = mouse.isLeftButtonPressed();
-    
-    bool isHovering = contains(mouseX, mouseY);
-    bool wasHovering = active;
-    active = isHovering;
-    
-    if (isHovering && !wasHovering && onHover) {
-        auto event = MouseEvent(EventType::MOUSE_ENTER, mouseX, mouseY);
-        onHover(event);
-    } else if (!isHovering && wasHovering && onLeave) {
-        auto event = MouseEvent(EventType::MOUSE_LEAVE, mouseX, mouseY);
-        onLeave(event);
-    }
-    
-    int currentHoverIndex = isHovering ? getItemAtPosition(mouseX, mouseY) : -1;
-    if (currentHoverIndex != hoveredIndex) {
-        if (hoveredIndex >= 0 && onItemLeave) {
-            generateListEvent(EventType::MOUSE_LEAVE, hoveredIndex);
-        }
-        hoveredIndex = currentHoverIndex;
-        if (hoveredIndex >= 0 && onItemHover) {
-            generateListEvent(EventType::MOUSE_ENTER, hoveredIndex);
+void ListBox::handlePointer(const MouseEvent& event) {
+    switch (event.type) {
+        case EventType::MOUSE_ENTER:
+            active = true;
+            if (onHover) onHover(event);
+            setHoveredIndex(getItemAtPosition(event.x, event.y));
+            break;
+        case EventType::MOUSE_MOVE:
+            setHoveredIndex(getItemAtPosition(event.x, event.y));
+            break;
+        case EventType::MOUSE_LEAVE:
+            active = false;
+            if (onLeave) onLeave(event);
+            setHoveredIndex(-1);
+            break;
+        case EventType::MOUSE_PRESS: {
+            int clickedIndex = getItemAtPosition(event.x, event.y);
+            if (clickedIndex >= 0 && items[clickedIndex].enabled && !items[clickedIndex].separator) {
+                if (multiSelect) {
+                    setItemSelected(clickedIndex, !isItemSelected(clickedIndex));
+                } else {
+                    setSelectedIndex(clickedIndex);
+                }
+                generateListEvent(EventType::BUTTON_CLICK, clickedIndex);
+            }
+            break;
         }
-    }
-    
-    if (isHovering && leftPressed && !wasLeftPressed) {
-        int clickedIndex = getItemAtPosition(mouseX, mouseY);
-        if (clickedIndex >= 0 && items[clickedIndex].enabled && !items[clickedIndex].separator) {
-            if (multiSelect) {
-                setItemSelected(clickedIndex, !isItemSelected(clickedIndex));
-            } else {
-                setSelectedIndex(clickedIndex);
+        case EventType::MOUSE_WHEEL: {
+            // One coalesced delta per frame, so at most one repaint
+            int oldOffset = scrollOffset;
+            scrollBy(event.deltaY);
+            if (scrollOffset != oldOffset) {
+                setHoveredIndex(getItemAtPosition(event.x, event.y));
+                if (onScroll) onScroll(event);
+                if (parentWindow) parentWindow->invalidate();
             }
-            generateListEvent(EventType::BUTTON_CLICK, clickedIndex);
+            break;
         }
+        default:
+            break;
+    }
+}
+
+void ListBox::setHoveredIndex(int index) {
+    if (index == hoveredIndex) return;
+    if (hoveredIndex >= 0 && onItemLeave) {
+        generateListEvent(EventType::MOUSE_LEAVE, hoveredIndex);
+    }
+    hoveredIndex = index;
+    if (hoveredIndex >= 0 && onItemHover) {
+        generateListEvent(EventType::MOUSE_ENTER, hoveredIndex);
     }
-    
-    wasLeftPressed = leftPressed;
 }
 
 void ListBox::draw(UnicodeBuffer& buffer) {
     if (!visible || !parentWindow || !parentWindow->isVisible()) return;
     
-    int absX = parentWindow->x + x;
-    int absY = parentWindow->y + y;
+    // Draw in list-local coordinates through a view of the list's area
+    BufferView view = parentWindow->view(buffer).subView(Rect(x, y, width, height));
     
     // Draw border
-    buffer.drawBox(absX, absY, width, height, borderColor, true, false);
+    view.drawBox(0, 0, width, height, borderColor, true, false);
     
     // Fill background
-    for (int row = 1; row < height - 1; row++) {
-        for (int col = 1; col < width - 1; col++) {
-            buffer.setCell(absX + col, absY + row, " ", backgroundColor);
-        }
-    }
+    view.fillRect(1, 1, width - 2, height - 2, " ", backgroundColor);
     
     // Draw items
     int visibleCount = getVisibleItemCount();
@@ -227,13 +239,11 @@ void ListBox::draw(UnicodeBuffer& buffer) {
         int itemIndex = scrollOffset + i;
         const auto& item = items[itemIndex];
         
-        int itemY = absY + 1 + i;
+        int itemY = 1 + i;
         
         if (item.separator) {
             // Draw separator
-            for (int col = 1; col < width - 1; col++) {
-                buffer.setCell(absX + col, itemY, "─", separatorColor);
-            }
+            view.drawHLine(1, itemY, width - 2, "─", separatorColor);
         } else {
             // Determine item color
             std::string itemColor = item.color.empty() ? textColor : item.color;
@@ -249,32 +259,28 @@ void ListBox::draw(UnicodeBuffer& buffer) {
             // Draw selection indicator for multi-select
             if (multiSelect) {
                 std::string indicator = isItemSelected(itemIndex) ? "✓" : " ";
-                buffer.setCell(absX + 1, itemY, indicator, itemColor);
-                buffer.drawStringClipped(absX + 3, itemY, item.text, itemColor, absX + width - 1);
+                view.setCell(1, itemY, indicator, itemColor);
+                view.drawStringClipped(3, itemY, item.text, itemColor, width - 1);
             } else {
-                buffer.drawStringClipped(absX + 2, itemY, item.text, itemColor, absX + width - 1);
+                view.drawStringClipped(2, itemY, item.text, itemColor, width - 1);
             }
         }
     }
     
     // Draw scrollbar if needed
     if (showScrollbar && (int)items.size() > visibleCount) {
-        int scrollbarX = absX + width - 2;
+        int scrollbarX = width - 2;
         int scrollbarHeight = height - 2;
         
         // Draw scrollbar track
-        for (int i = 0; i < scrollbarHeight; i++) {
-            buffer.setCell(scrollbarX, absY + 1 + i, "│", scrollbarColor);
-        }
+        view.drawVLine(scrollbarX, 1, scrollbarHeight, "│", scrollbarColor);
         
         // Draw scroll thumb
         if (scrollbarHeight > 0 && !items.empty()) {
             int thumbSize = std::max(1, (visibleCount * scrollbarHeight) / (int)items.size());
             int thumbPos = (scrollOffset * (scrollbarHeight - thumbSize)) / std::max(1, (int)items.size() - visibleCount);
             
-            for (int i = 0; i < thumbSize; i++) {
-                buffer.setCell(scrollbarX, absY + 1 + thumbPos + i, "█", scrollThumbColor);
-            }
+            view.drawVLine(scrollbarX, 1 + thumbPos, thumbSize, "█", scrollThumbColor);
         }
     }
 }
@@ -297,6 +303,21 @@ bool ListBox::isItemSelected(int index) const {
 void ListBox::calculateDimensions() {
     if (width < 5) width = 5;
     if (height < 3) height = 3;
+    placePointerTarget();
+}
+
+void ListBox::placePointerTarget() {
+    bool hittable = visible && enabled;
+    pointer.place(hittable ? Rect(x, y, width, height) : Rect());
+}
+
+void ListBox::setEnabled(bool state) {
+    enabled = state;
+    if (!enabled) {
+        active = false;
+        setHoveredIndex(-1);
+    }
+    placePointerTarget();
 }
 
 void ListBox::generateListEvent(EventType type, int itemIndex) {
@@ -1,13 +1,19 @@
 #include "../include/mouse_handler.h"
 #include <iostream>
-#include <sstream>
 #include <signal.h>
+#include <cstring>
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
 
 struct termios orig_termios;
 bool terminal_initialized = false;
 
 void cleanup(int sig) {
     if (terminal_initialized) {
+        // Frames may have left stdout non-blocking; the reset must get out
+        int flags = fcntl(STDOUT_FILENO, F_GETFL);
+        if (flags >= 0) fcntl(STDOUT_FILENO, F_SETFL, flags & ~O_NONBLOCK);
         std::cout << "\033[?1003l\033[?1006l\033[?1000l\033[?25h\033[2J\033[H\033[0m" << std::flush;
         tcsetattr(STDIN_FILENO, TCSAFLUSH, &orig_termios);
     }
@@ -15,77 +21,124 @@ void cleanup(int sig) {
 }
 
 void FastMouseHandler::processAllAvailableInput() {
-    char largeChunk[1024];
+    char largeChunk[4096];
     ssize_t bytes = read(STDIN_FILENO, largeChunk, sizeof(largeChunk));
     
     if (bytes <= 0) return;
     
-    for (ssize_t i = 0; i < bytes; i++) {
-        char ch = largeChunk[i];
-        
-        if (ch == 'q' || ch == 'Q') {
+    if (inputBuffer.empty()) {
+        size_t consumed = feedInput(largeChunk, bytes);
+        inputBuffer.assign(largeChunk + consumed, bytes - consumed);
+    } else {
+        // Complete the report that was split across reads
+        inputBuffer.append(largeChunk, bytes);
+        size_t consumed = feedInput(inputBuffer.data(), inputBuffer.size());
+        inputBuffer.erase(0, consumed);
+    }
+}
+
+// Decodes a DA1 reply "ESC [ ? Ps ; ... c". Same return convention as
+// fast_decode_sgr_mouse: bytes consumed, 0 if incomplete, -1 if not a reply.
+static int decodeDeviceAttributes(const char* data, size_t length, std::vector<int>& attributes) {
+    static const char prefix[] = "\033[?";
+    if (memcmp(data, prefix, std::min(length, (size_t)3)) != 0) return -1;
+    if (length <= 3) return 0;
+    
+    std::vector<int> values;
+    int value = 0;
+    for (size_t i = 3; i < length && i < 64; i++) {
+        char c = data[i];
+        if (c >= '0' && c <= '9') {
+            value = value * 10 + (c - '0');
+        } else if (c == ';') {
+            values.push_back(value);
+            value = 0;
+        } else if (c == 'c') {
+            values.push_back(value);
+            attributes.swap(values);
+            return (int)i + 1;
+        } else {
+            return -1;
+        }
+    }
+    return length < 64 ? 0 : -1;
+}
+
+size_t FastMouseHandler::feedInput(const char* data, size_t length) {
+    size_t pos = 0;
+    
+    while (pos < length) {
+        // Skip to the next escape, quitting on q/Q in plain input
+        auto scan = ASMOptimized::fast_parse_mouse_input(data + pos, length - pos);
+        if (scan.found_quit) {
             cleanup(0);
         }
+        if (!scan.found_escape) {
+            return length;
+        }
+        pos += scan.escape_pos;
         
-        if (ch == '\033') {
-            inputBuffer.clear();
-            inputBuffer += ch;
-        } else if (!inputBuffer.empty()) {
-            inputBuffer += ch;
-            
-            if (inputBuffer.length() > 30) {
-                inputBuffer.clear();
-                continue;
+        ASMOptimized::SGRMouseEvent event;
+        int n = ASMOptimized::fast_decode_sgr_mouse(data + pos, length - pos, event);
+        if (n == 0) {
+            break; // Incomplete report, keep it for the next read
+        }
+        if (n < 0) {
+            n = decodeDeviceAttributes(data + pos, length - pos, deviceAttributes);
+            if (n == 0) {
+                break;
             }
-            
-            if (inputBuffer.length() >= 6 && inputBuffer.substr(0, 3) == "\033[<") {
-                size_t mPos = inputBuffer.find('M');
-                size_t lowerMPos = inputBuffer.find('m');
-                
-                if (mPos != std::string::npos || lowerMPos != std::string::npos) {
-                    size_t endPos = (mPos != std::string::npos) ? mPos : lowerMPos;
-                    bool isPress = (inputBuffer[endPos] == 'M');
-                    
-                    std::string data = inputBuffer.substr(3, endPos - 3);
-                    inputBuffer.clear();
-                    
-                    parseMouseData(data, isPress);
-                }
+            if (n > 0) {
+                deviceAttributesReceived = true;
+                pos += n;
+            } else {
+                pos++; // Not a mouse report, drop the escape byte
             }
+            continue;
+        }
+        
+        if (recorder) {
+            recorder->recordMouse(event);
         }
+        applyMouseEvent(event);
+        pos += n;
     }
+    
+    return pos;
 }
 
-void FastMouseHandler::parseMouseData(const std::string& data, bool isPress) {
-    std::istringstream ss(data);
-    std::string buttonStr, xStr, yStr;
+void FastMouseHandler::applyMouseEvent(const ASMOptimized::SGRMouseEvent& event) {
+    int x = event.x - 1;
+    int y = event.y - 1;
     
-    if (std::getline(ss, buttonStr, ';') &&
-        std::getline(ss, xStr, ';') &&
-        std::getline(ss, yStr)) {
+    if (x >= 0 && x < 200 && y >= 0 && y < 100) {
+        // Always update mouse position regardless of button state
+        currentX = x;
+        currentY = y;
         
-        try {
-            int button = std::stoi(buttonStr);
-            int x = std::stoi(xStr) - 1;
-            int y = std::stoi(yStr) - 1;
-            
-            if (x >= 0 && x < 200 && y >= 0 && y < 100) {
-                // Always update mouse position regardless of button state
-                currentX = x;
-                currentY = y;
-                
-                // Handle left button state separately
-                bool isLeftButton = (button & 3) == 0;
-                if (isLeftButton) {
-                    if (isPress && !leftPressed) {
-                        leftPressed = true;
-                    } else if (!isPress && leftPressed) {
-                        leftPressed = false;
-                    }
+        // Wheel buttons 64-67 (up, down, left, right) only ever press;
+        // their low bits would otherwise read as the left button
+        if (event.button & 64) {
+            if (event.press) {
+                int direction = (event.button & 1) ? 1 : -1;
+                bool horizontal = (event.button & 2) || (event.button & 4);
+                if (horizontal) {
+                    wheelTicksX += direction;
+                } else {
+                    wheelTicksY += direction;
                 }
             }
-        } catch (...) {
-            // Ignore parsing errors
+            return;
+        }
+        
+        // Handle left button state separately
+        bool isLeftButton = (event.button & 3) == 0;
+        if (isLeftButton) {
+            if (event.press && !leftPressed) {
+                leftPressed = true;
+            } else if (!event.press && leftPressed) {
+                leftPressed = false;
+            }
         }
     }
 }
@@ -95,5 +148,16 @@ void FastMouseHandler::enableMouse() {
 }
 
 void FastMouseHandler::updateMouse() {
+    beginFrame();
     processAllAvailableInput();
+}
+
+void FastMouseHandler::beginFrame() {
+    wheelTicksX = 0;
+    wheelTicksY = 0;
+}
+
+int FastMouseHandler::wheelLines(int ticks) const {
+    int multiplier = wheelAcceleration ? std::min(4, std::max(1, std::abs(ticks))) : 1;
+    return ticks * wheelLinesPerTick * multiplier;
 }
\ No newline at end of file
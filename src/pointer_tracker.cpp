@@ -0,0 +1,197 @@
+#include "../include/pointer_tracker.h"
+#include "../include/buffer.h"
+#include <algorithm>
+
+PointerTracker::PointerTracker()
+    : layoutVersion(0), seenLayoutVersion(0), lastX(-1), lastY(-1), lastPressed(false),
+      hovered(0), pressed(0), focused(0) {}
+
+PointerTracker& PointerTracker::getInstance() {
+    static PointerTracker instance;
+    return instance;
+}
+
+void PointerTracker::resize(int w, int h) {
+    index.resize(w, h);
+    layoutVersion++;
+}
+
+void PointerTracker::addTarget(uint32_t id, uint32_t parent, Handler handler) {
+    if (id == 0) return;
+    
+    // Parents may be registered after their first child created them
+    auto existing = targets.find(id);
+    if (existing != targets.end()) {
+        existing->second.handler = std::move(handler);
+        return;
+    }
+    
+    Target& target = targets[id];
+    target.parent = parent;
+    target.handler = std::move(handler);
+    if (parent != 0) {
+        targets[parent].children.push_back(id);
+    }
+}
+
+void PointerTracker::setTargetRect(uint32_t id, const Rect& rect, uint32_t depth) {
+    auto it = targets.find(id);
+    if (it == targets.end()) return;
+    
+    Target& target = it->second;
+    if (target.rect == rect && target.depth == depth) return;
+    target.rect = rect;
+    target.depth = depth;
+    if (target.parent == 0) {
+        index.set(id, rect, depth);
+    }
+    layoutVersion++;
+}
+
+void PointerTracker::removeTarget(uint32_t id) {
+    auto it = targets.find(id);
+    if (it == targets.end()) return;
+    
+    auto parent = targets.find(it->second.parent);
+    if (it->second.parent != 0 && parent != targets.end()) {
+        std::vector<uint32_t>& siblings = parent->second.children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), id), siblings.end());
+    }
+    if (it->second.parent == 0) {
+        index.remove(id);
+    }
+    targets.erase(it);
+    
+    // Gone without a leave or blur; whatever is under the pointer now gets
+    // an enter on the next update
+    if (hovered == id) hovered = 0;
+    if (pressed == id) pressed = 0;
+    if (focused == id) focused = 0;
+    layoutVersion++;
+}
+
+void PointerTracker::setScrollable(uint32_t id, bool scrollable) {
+    auto it = targets.find(id);
+    if (it != targets.end()) it->second.scrollable = scrollable;
+}
+
+uint32_t PointerTracker::targetAt(int x, int y) const {
+    uint32_t id = index.query(x, y);
+    
+    // Descend into the topmost child containing the point, moving the
+    // point into each parent's coordinates on the way down
+    while (id != 0) {
+        const Target& target = targets.find(id)->second;
+        x -= target.rect.x;
+        y -= target.rect.y;
+        
+        uint32_t hit = 0;
+        uint32_t hitDepth = 0;
+        for (uint32_t child : target.children) {
+            const Target& candidate = targets.find(child)->second;
+            if (candidate.rect.contains(x, y) && (hit == 0 || candidate.depth >= hitDepth)) {
+                hit = child;
+                hitDepth = candidate.depth;
+            }
+        }
+        if (hit == 0) break;
+        id = hit;
+    }
+    return id;
+}
+
+void PointerTracker::send(uint32_t id, EventType type, int x, int y, int button) {
+    auto it = targets.find(id);
+    if (it == targets.end() || !it->second.handler) return;
+    
+    // Handlers may add or remove targets; call a copy so the map can change
+    Handler handler = it->second.handler;
+    handler(MouseEvent(type, x, y, button));
+}
+
+void PointerTracker::update(int x, int y, bool leftPressed) {
+    bool moved = x != lastX || y != lastY;
+    bool relaid = layoutVersion != seenLayoutVersion;
+    if (!moved && !relaid && leftPressed == lastPressed) return;
+    lastX = x;
+    lastY = y;
+    seenLayoutVersion = layoutVersion;
+    
+    uint32_t hit = targetAt(x, y);
+    if (hit != hovered) {
+        uint32_t previous = hovered;
+        hovered = hit;
+        if (previous != 0) send(previous, EventType::MOUSE_LEAVE, x, y);
+        if (hit != 0) send(hit, EventType::MOUSE_ENTER, x, y);
+    } else if (hit != 0 && (moved || relaid)) {
+        // Still over the same target, maybe over a different part of it
+        send(hit, EventType::MOUSE_MOVE, x, y);
+    }
+    
+    if (leftPressed && !lastPressed) {
+        lastPressed = true;
+        pressed = hit;
+        setFocus(hit);
+        if (hit != 0) send(hit, EventType::MOUSE_PRESS, x, y, 0);
+    } else if (!leftPressed && lastPressed) {
+        lastPressed = false;
+        uint32_t target = pressed;
+        pressed = 0;
+        if (target != 0) {
+            send(target, EventType::MOUSE_RELEASE, x, y, 0);
+            if (hit == target) send(target, EventType::BUTTON_CLICK, x, y, 0);
+        }
+    } else if (leftPressed && moved && pressed != 0) {
+        // The pressed target keeps getting the pointer until release
+        send(pressed, EventType::MOUSE_DRAG, x, y, 0);
+    }
+}
+
+void PointerTracker::wheel(int deltaX, int deltaY) {
+    if (deltaX == 0 && deltaY == 0) return;
+    
+    // Up from the hovered target, so a list inside a window scrolls the
+    // list and a checkbox inside it scrolls the window
+    uint32_t id = hovered;
+    while (id != 0) {
+        auto it = targets.find(id);
+        if (it == targets.end()) return;
+        if (it->second.scrollable && it->second.handler) break;
+        id = it->second.parent;
+    }
+    if (id == 0) return;
+    
+    MouseEvent event(EventType::MOUSE_WHEEL, lastX, lastY);
+    event.deltaX = deltaX;
+    event.deltaY = deltaY;
+    Handler handler = targets.find(id)->second.handler;
+    handler(event);
+}
+
+void PointerTracker::setFocus(uint32_t id) {
+    if (id == focused) return;
+    uint32_t previous = focused;
+    focused = id;
+    if (previous != 0) send(previous, EventType::WINDOW_BLUR, lastX, lastY);
+    if (id != 0) send(id, EventType::WINDOW_FOCUS, lastX, lastY);
+}
+
+void PointerTarget::attach(uint32_t parent, PointerTracker::Handler handler) {
+    detach();
+    id = UnicodeBuffer::allocateOwnerId();
+    PointerTracker::getInstance().addTarget(id, parent, std::move(handler));
+}
+
+void PointerTarget::detach() {
+    if (id == 0) return;
+    PointerTracker::getInstance().removeTarget(id);
+    id = 0;
+}
+
+void PointerTarget::place(const Rect& rect, uint32_t depth) {
+    PointerTracker::getInstance().setTargetRect(id, rect, depth);
+}
+
+void PointerTarget::setScrollable(bool scrollable) {
+    PointerTracker::getInstance().setScrollable(id, scrollable);
+}
@@ -0,0 +1,129 @@
+#include "../include/present_thread.h"
+
+PresentThread::PresentThread(TerminalOutput& output)
+    : output(output), presenting(-1), pending(-1), stopping(false), attributesPending(false),
+      presentedFrames(0), supersededFrames(0) {
+    thread = std::thread(&PresentThread::run, this);
+}
+
+PresentThread::~PresentThread() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void PresentThread::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return stopping || pending >= 0 || attributesPending; });
+        
+        // Only this thread touches the output, so it can be used under the lock
+        if (attributesPending) {
+            output.handleDeviceAttributes(attributes);
+            attributesPending = false;
+        }
+        if (pending < 0) {
+            if (stopping) return;
+            continue;
+        }
+        
+        presenting = pending;
+        pending = -1;
+        std::vector<PendingCopy> copies;
+        copies.swap(pendingCopies);
+        lock.unlock();
+        
+        for (const PendingCopy& copy : copies) {
+            output.copyRect(copy.source, copy.dstX, copy.dstY);
+        }
+        bool sent = output.present(*slots[presenting]);
+        
+        // A non-blocking output may leave part of the frame behind. Wait it
+        // out here, unlocked, so submits keep replacing the pending frame.
+        while (output.isDraining()) {
+            output.waitWritable(-1);
+            output.flush();
+        }
+        
+        lock.lock();
+        if (sent) {
+            presentedFrames++;
+        } else if (pending < 0) {
+            // Skipped behind a backlog and nothing newer came: send it now
+            pending = presenting;
+        } else {
+            supersededFrames++;
+        }
+        presenting = -1;
+        idle.notify_all();
+    }
+}
+
+void PresentThread::submit(const UnicodeBuffer& frame) {
+    int slot;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        slot = 0;
+        while (slot == presenting || slot == pending) {
+            slot++;
+        }
+    }
+    
+    // The free slot belongs to this thread until it is published below.
+    // Snapshots of the same buffer only copy the tiles drawn since.
+    std::unique_ptr<UnicodeBuffer>& buffer = slots[slot];
+    if (!buffer || buffer->getWidth() != frame.getWidth() || buffer->getHeight() != frame.getHeight()) {
+        buffer.reset(new UnicodeBuffer(frame.getWidth(), frame.getHeight()));
+    }
+    buffer->snapshotFrom(frame);
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pending >= 0) {
+            // The waiting frame is never shown. Its copies were still made
+            // relative to the frame before it, so they carry over.
+            supersededFrames++;
+        }
+        pending = slot;
+        pendingCopies.insert(pendingCopies.end(), nextCopies.begin(), nextCopies.end());
+        nextCopies.clear();
+    }
+    wake.notify_one();
+}
+
+void PresentThread::copyRect(const Rect& source, int dstX, int dstY) {
+    PendingCopy copy;
+    copy.source = source;
+    copy.dstX = dstX;
+    copy.dstY = dstY;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    nextCopies.push_back(copy);
+}
+
+void PresentThread::handleDeviceAttributes(const std::vector<int>& reply) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        attributes = reply;
+        attributesPending = true;
+    }
+    wake.notify_one();
+}
+
+void PresentThread::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return pending < 0 && presenting < 0; });
+}
+
+size_t PresentThread::getPresentedFrames() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return presentedFrames;
+}
+
+size_t PresentThread::getSupersededFrames() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return supersededFrames;
+}
@@ -137,8 +137,8 @@ void ProgressBar::updateMouse(FastMouseHandler& mouse, int termWidth, int termHe
 void ProgressBar::draw(UnicodeBuffer& buffer) {
     if (!visible || !parentWindow || !parentWindow->isVisible()) return;
     
-    int absX = parentWindow->x + x;
-    int absY = parentWindow->y + y;
+    // Window-local coordinates; the view clips to the window's interior
+    BufferView view = parentWindow->view(buffer);
     
     // Calculate progress
     double progress = getPercentage() / 100.0;
@@ -168,7 +168,7 @@ void ProgressBar::draw(UnicodeBuffer& buffer) {
                 cellColor = emptyColor;
             }
             
-            buffer.setCell(absX + col, absY + row, cellChar, cellColor);
+            view.setCell(x + col, y + row, cellChar, cellColor);
         }
     }
     
@@ -194,18 +194,18 @@ void ProgressBar::draw(UnicodeBuffer& buffer) {
         }
         
         // Center the text
-        int textX = absX + (width - (int)displayText.length()) / 2;
-        int textY = absY + height / 2;
+        int textX = x + (width - (int)displayText.length()) / 2;
+        int textY = y + height / 2;
         
-        if (textX >= absX && textX + (int)displayText.length() <= absX + width) {
-            buffer.drawStringClipped(textX, textY, displayText, textColor, absX + width);
+        if (textX >= x && textX + (int)displayText.length() <= x + width) {
+            view.drawStringClipped(textX, textY, displayText, textColor, x + width);
         }
     }
     
     // Draw border if specified
     if (borderStyle == "single" && height > 1) {
         // Simple border for multi-line progress bars
-        buffer.drawBox(absX - 1, absY - 1, width + 2, height + 2, borderColor, true, false);
+        view.drawBox(x - 1, y - 1, width + 2, height + 2, borderColor, true, false);
     }
 }
 
@@ -0,0 +1,132 @@
+#include "../include/region.h"
+#include <algorithm>
+
+Rect Rect::intersect(const Rect& other) const {
+    int x0 = std::max(x, other.x);
+    int y0 = std::max(y, other.y);
+    int x1 = std::min(x + w, other.x + other.w);
+    int y1 = std::min(y + h, other.y + other.h);
+    if (x0 >= x1 || y0 >= y1) return Rect();
+    return Rect(x0, y0, x1 - x0, y1 - y0);
+}
+
+void SpanRegion::reset(int w, int h) {
+    width = std::max(0, w);
+    height = std::max(0, h);
+    rows.resize(height);
+    clear();
+}
+
+void SpanRegion::clear() {
+    // Keep each row's capacity; the compositor rebuilds this every frame
+    for (auto& spans : rows) {
+        spans.clear();
+    }
+}
+
+void SpanRegion::addRect(const Rect& r) {
+    Rect clipped = r.intersect(Rect(0, 0, width, height));
+    if (clipped.empty()) return;
+    
+    int x0 = clipped.x;
+    int x1 = clipped.x + clipped.w;
+    
+    for (int y = clipped.y; y < clipped.y + clipped.h; y++) {
+        std::vector<Span>& spans = rows[y];
+        
+        // Find the first span that touches [x0, x1) and the first one past it
+        auto first = std::lower_bound(spans.begin(), spans.end(), x0,
+                                      [](const Span& s, int value) { return s.x1 < value; });
+        auto last = first;
+        Span merged = { x0, x1 };
+        while (last != spans.end() && last->x0 <= x1) {
+            merged.x0 = std::min(merged.x0, last->x0);
+            merged.x1 = std::max(merged.x1, last->x1);
+            ++last;
+        }
+        
+        if (first == last) {
+            spans.insert(first, merged);
+        } else {
+            *first = merged;
+            spans.erase(first + 1, last);
+        }
+    }
+}
+
+bool SpanRegion::coversRect(const Rect& r) const {
+    Rect clipped = r.intersect(Rect(0, 0, width, height));
+    if (clipped.empty()) return true;
+    
+    int x0 = clipped.x;
+    int x1 = clipped.x + clipped.w;
+    
+    for (int y = clipped.y; y < clipped.y + clipped.h; y++) {
+        const std::vector<Span>& spans = rows[y];
+        auto it = std::lower_bound(spans.begin(), spans.end(), x0,
+                                   [](const Span& s, int value) { return s.x1 <= value; });
+        if (it == spans.end() || it->x0 > x0 || it->x1 < x1) return false;
+    }
+    return true;
+}
+
+void SpanRegion::subtractFrom(const Rect& r, std::vector<Rect>& out) const {
+    collect(r, out, false);
+}
+
+void SpanRegion::intersectFrom(const Rect& r, std::vector<Rect>& out) const {
+    collect(r, out, true);
+}
+
+void SpanRegion::collect(const Rect& r, std::vector<Rect>& out, bool inside) const {
+    Rect clipped = r.intersect(Rect(0, 0, width, height));
+    if (clipped.empty()) return;
+    
+    int x0 = clipped.x;
+    int x1 = clipped.x + clipped.w;
+    
+    // Rects emitted for the previous row, still open for vertical merging
+    size_t openBegin = out.size();
+    size_t openEnd = out.size();
+    
+    for (int y = clipped.y; y < clipped.y + clipped.h; y++) {
+        const std::vector<Span>& spans = rows[y];
+        size_t rowBegin = out.size();
+        
+        int cursor = x0;
+        auto it = std::lower_bound(spans.begin(), spans.end(), x0,
+                                   [](const Span& s, int value) { return s.x1 <= value; });
+        for (; it != spans.end() && it->x0 < x1; ++it) {
+            if (inside) {
+                int s0 = std::max(x0, it->x0);
+                int s1 = std::min(x1, it->x1);
+                out.push_back(Rect(s0, y, s1 - s0, 1));
+            } else if (it->x0 > cursor) {
+                out.push_back(Rect(cursor, y, it->x0 - cursor, 1));
+            }
+            cursor = std::max(cursor, it->x1);
+        }
+        if (!inside && cursor < x1) {
+            out.push_back(Rect(cursor, y, x1 - cursor, 1));
+        }
+        
+        // Same spans as the row above: grow those rects instead
+        size_t rowCount = out.size() - rowBegin;
+        bool same = rowCount > 0 && rowCount == openEnd - openBegin;
+        for (size_t i = 0; same && i < rowCount; i++) {
+            const Rect& above = out[openBegin + i];
+            const Rect& here = out[rowBegin + i];
+            same = above.x == here.x && above.w == here.w;
+        }
+        
+        if (same) {
+            for (size_t i = openBegin; i < openEnd; i++) {
+                out[i].h++;
+            }
+            out.resize(rowBegin);
+        } else {
+            openBegin = rowBegin;
+            openEnd = out.size();
+        }
+    }
+}
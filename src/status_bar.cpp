@@ -18,7 +18,8 @@ StatusBar::StatusBar(std::shared_ptr<Window> parent, int x, int y, int width, in
       backgroundColor(Color::WHITE + Color::BG_BLUE), defaultTextColor(Color::BRIGHT_WHITE + Color::BG_BLUE),
       separatorChar("|"), separatorColor(Color::CYAN + Color::BG_BLUE),
       autoWidth(true), showSeparators(true),
-      wasLeftPressed(false), hoveredSegment(-1) {
+      hoveredSegment(-1), displayListValid(false) {
+    pointer.attach(parent ? parent->id : 0, [this](const MouseEvent& event) { handlePointer(event); });
     calculateDimensions();
 }
 
@@ -36,19 +37,22 @@ void StatusBar::addSegment(const StatusBarSegment& segment) {
 void StatusBar::setSegmentText(int index, const std::string& text) {
     if (index >= 0 && index < (int)segments.size()) {
         segments[index].text = text;
+        invalidate();
     }
 }
 
 void StatusBar::setSegmentColor(int index, const std::string& color) {
     if (index >= 0 && index < (int)segments.size()) {
         segments[index].color = color;
+        invalidate();
     }
 }
 
 void StatusBar::setSegmentClickable(int index, bool clickable, std::function<void()> callback) {
     if (index >= 0 && index < (int)segments.size()) {
         segments[index].clickable = clickable;
-        segments[index].onClick = callback;
+        segments[index].onClick = std::move(callback);
+        invalidate();
     }
 }
 
@@ -82,7 +86,7 @@ void StatusBar::addProgressSegment(const std::string& label, double percentage,
 
 void StatusBar::addClickableSegment(const std::string& text, std::function<void()> callback, const std::string& color) {
     StatusBarSegment segment(text, color.empty() ? defaultTextColor : color, -1, false, true);
-    segment.onClick = callback;
+    segment.onClick = std::move(callback);
     segments.push_back(segment);
     calculateDimensions();
 }
@@ -106,6 +110,7 @@ void StatusBar::updateTimeSegments() {
             std::ostringstream oss;
             oss << std::put_time(std::localtime(&time_t), "%H:%M:%S");
             segments[i].text = oss.str();
+            invalidate();
         }
     }
 }
@@ -114,6 +119,7 @@ void StatusBar::setShowSeparators(bool show, const std::string& separator, const
     showSeparators = show;
     if (!separator.empty()) separatorChar = separator;
     if (!color.empty()) separatorColor = color;
+    invalidate();
 }
 
 void StatusBar::setColors(const std::string& background, const std::string& defaultText, const std::string& separator) {
@@ -127,6 +133,7 @@ void StatusBar::setColors(const std::string& background, const std::string& defa
             segment.color = defaultTextColor;
         }
     }
+    invalidate();
 }
 
 void StatusBar::calculateDimensions() {
@@ -137,6 +144,14 @@ void StatusBar::calculateDimensions() {
     // Ensure minimum dimensions
     if (width < 1) width = 1;
     if (height < 1) height = 1;
+    
+    // Every change to the segment list or size passes through here
+    invalidate();
+    placePointerTarget();
+}
+
+void StatusBar::placePointerTarget() {
+    pointer.place(visible ? Rect(x, y, width, height) : Rect());
 }
 
 std::vector<int> StatusBar::calculateSegmentPositions() const {
@@ -224,72 +239,74 @@ bool StatusBar::contains(int mx, int my) const {
     return mx >= absX && mx < absX + width && my >= absY && my < absY + height;
 }
 
-void StatusBar::updateMouse(FastMouseHandler& mouse, int termWidth, int termHeight) {
-    if (!visible || !parentWindow || !parentWindow->isVisible()) return;
-    
-    int mouseX = mouse.getMouseX();
-    int mouseY = mouse.getMouseY();
-    bool leftPressed = mouse.isLeftButtonPressed();
-    
-    bool isHovering = contains(mouseX, mouseY);
-    bool wasHovering = active;
-    active = isHovering;
-    
-    int currentHoverSegment = isHovering ? getSegmentAtPosition(mouseX, mouseY) : -1;
-    int prevHoverSegment = hoveredSegment;
-    hoveredSegment = currentHoverSegment;
-    
-    // Generate hover/leave events for status bar
-    if (isHovering && !wasHovering && onHover) {
-        auto event = MouseEvent(EventType::MOUSE_ENTER, mouseX, mouseY);
-        onHover(event);
-    } else if (!isHovering && wasHovering && onLeave) {
-        auto event = MouseEvent(EventType::MOUSE_LEAVE, mouseX, mouseY);
-        onLeave(event);
-    }
-    
-    // Generate hover/leave events for segments
-    if (currentHoverSegment != prevHoverSegment) {
-        if (prevHoverSegment >= 0 && onSegmentLeave) {
-            generateStatusEvent(EventType::MOUSE_LEAVE, prevHoverSegment, "leave");
-        }
-        if (currentHoverSegment >= 0 && onSegmentHover) {
-            generateStatusEvent(EventType::MOUSE_ENTER, currentHoverSegment, "hover");
-        }
-    }
-    
-    // Handle click events
-    if (isHovering && leftPressed && !wasLeftPressed) {
-        int clickedSegment = getSegmentAtPosition(mouseX, mouseY);
-        
-        if (clickedSegment >= 0) {
-            const auto& segment = segments[clickedSegment];
-            
-            // Execute segment's onClick callback if it has one
-            if (segment.clickable && segment.onClick) {
-                segment.onClick();
+void StatusBar::handlePointer(const MouseEvent& event) {
+    switch (event.type) {
+        case EventType::MOUSE_ENTER:
+            active = true;
+            if (onHover) onHover(event);
+            setHoveredSegment(getSegmentAtPosition(event.x, event.y));
+            break;
+        case EventType::MOUSE_MOVE:
+            setHoveredSegment(getSegmentAtPosition(event.x, event.y));
+            break;
+        case EventType::MOUSE_LEAVE:
+            active = false;
+            if (onLeave) onLeave(event);
+            setHoveredSegment(-1);
+            break;
+        case EventType::MOUSE_PRESS: {
+            int clickedSegment = getSegmentAtPosition(event.x, event.y);
+            if (clickedSegment >= 0) {
+                const auto& segment = segments[clickedSegment];
+                
+                // Execute segment's onClick callback if it has one
+                if (segment.clickable && segment.onClick) {
+                    segment.onClick();
+                }
+                
+                // Generate segment click event
+                generateStatusEvent(EventType::MOUSE_PRESS, clickedSegment, "click");
             }
-            
-            // Generate segment click event
-            generateStatusEvent(EventType::MOUSE_PRESS, clickedSegment, "click");
+            break;
         }
+        default:
+            break;
+    }
+}
+
+void StatusBar::setHoveredSegment(int index) {
+    if (index == hoveredSegment) return;
+    int previous = hoveredSegment;
+    hoveredSegment = index;
+    invalidate();
+    
+    if (previous >= 0 && onSegmentLeave) {
+        generateStatusEvent(EventType::MOUSE_LEAVE, previous, "leave");
+    }
+    if (index >= 0 && onSegmentHover) {
+        generateStatusEvent(EventType::MOUSE_ENTER, index, "hover");
     }
-    
-    wasLeftPressed = leftPressed;
 }
 
 void StatusBar::draw(UnicodeBuffer& buffer) {
     if (!visible || !parentWindow || !parentWindow->isVisible()) return;
     
-    int absX = parentWindow->x + x;
-    int absY = parentWindow->y + y;
-    
-    // Fill background
-    for (int row = 0; row < height; row++) {
-        for (int col = 0; col < width; col++) {
-            buffer.setCell(absX + col, absY + row, " ", backgroundColor);
-        }
+    // The bar's calls are recorded in local coordinates, so a moved window
+    // replays the same list at its new position
+    buffer.pushTranslation(parentWindow->x + x, parentWindow->y + y);
+    if (!displayListValid) {
+        buffer.beginRecording(displayList);
+        drawContents(buffer);
+        buffer.endRecording();
+        displayListValid = true;
     }
+    buffer.replay(displayList);
+    buffer.pop();
+}
+
+void StatusBar::drawContents(UnicodeBuffer& buffer) {
+    // Fill background
+    buffer.fillRect(0, 0, width, height, " ", backgroundColor);
     
     if (segments.empty()) return;
     
@@ -300,7 +317,7 @@ void StatusBar::draw(UnicodeBuffer& buffer) {
         if (i >= (int)positions.size()) break;
         
         const auto& segment = segments[i];
-        int segmentX = absX + positions[i];
+        int segmentX = positions[i];
         int segmentEnd = (i < (int)positions.size() - 1) ? positions[i + 1] : width;
         
         if (showSeparators && i < (int)segments.size() - 1) {
@@ -330,13 +347,13 @@ void StatusBar::draw(UnicodeBuffer& buffer) {
             segmentX += padding;
         }
         
-        buffer.drawStringClipped(segmentX, absY, displayText, textColor, absX + width);
+        buffer.drawStringClipped(segmentX, 0, displayText, textColor, width);
         
         // Draw separator
         if (showSeparators && i < (int)segments.size() - 1) {
-            int separatorX = absX + segmentEnd;
-            if (separatorX < absX + width) {
-                buffer.setCell(separatorX, absY, separatorChar, separatorColor);
+            int separatorX = segmentEnd;
+            if (separatorX < width) {
+                buffer.setCell(separatorX, 0, separatorChar, separatorColor);
             }
         }
     }
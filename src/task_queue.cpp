@@ -0,0 +1,107 @@
+#include "../include/task_queue.h"
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstdint>
+
+TaskQueue::TaskQueue() : tail(&stub), pending(0), wakePending(false) {
+    stub.next.store(nullptr, std::memory_order_relaxed);
+    head.store(&stub, std::memory_order_relaxed);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+TaskQueue::~TaskQueue() {
+    // Tasks nobody drained are dropped
+    while (Node* node = pop()) {
+        delete node;
+    }
+    if (wakeFd >= 0) close(wakeFd);
+}
+
+void TaskQueue::push(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = head.exchange(node, std::memory_order_acq_rel);
+    // Between the exchange and this store the list is briefly cut; pop()
+    // sees that as empty and the node turns up on a later drain
+    previous->next.store(node, std::memory_order_release);
+}
+
+TaskQueue::Node* TaskQueue::pop() {
+    Node* node = tail;
+    Node* next = node->next.load(std::memory_order_acquire);
+    if (node == &stub) {
+        if (!next) return nullptr;
+        tail = next;
+        node = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        tail = next;
+        return node;
+    }
+    
+    // `node` is the last one linked; leave it while a producer is midway
+    if (node != head.load(std::memory_order_acquire)) return nullptr;
+    
+    // Put the stub behind it so `node` can be detached
+    push(&stub);
+    next = node->next.load(std::memory_order_acquire);
+    if (next) {
+        tail = next;
+        return node;
+    }
+    return nullptr;
+}
+
+void TaskQueue::post(Task task) {
+    if (!task) return;
+    
+    Node* node = new Node;
+    node->task = std::move(task);
+    pending.fetch_add(1, std::memory_order_relaxed);
+    push(node);
+    
+    // One wake-up per batch, however many producers post into it
+    if (wakeFd >= 0 && !wakePending.exchange(true, std::memory_order_acq_rel)) {
+        uint64_t one = 1;
+        ssize_t written = write(wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+size_t TaskQueue::drain() {
+    // Consume the wake-up, then re-arm it before looking, so a post racing
+    // with the drain either lands in this batch or signals again
+    if (wakePending.load(std::memory_order_acquire)) {
+        if (wakeFd >= 0) {
+            uint64_t value;
+            ssize_t got = read(wakeFd, &value, sizeof(value));
+            (void)got;
+        }
+        wakePending.store(false, std::memory_order_seq_cst);
+    }
+    
+    size_t batch = pending.load(std::memory_order_acquire);
+    size_t ran = 0;
+    while (ran < batch) {
+        Node* node = pop();
+        if (!node) break;
+        pending.fetch_sub(1, std::memory_order_relaxed);
+        node->task();
+        delete node;
+        ran++;
+    }
+    return ran;
+}
+
+void TaskQueue::wait(int timeoutMs) {
+    if (wakeFd < 0) {
+        usleep(timeoutMs * 1000);
+        return;
+    }
+    struct pollfd fd;
+    fd.fd = wakeFd;
+    fd.events = POLLIN;
+    fd.revents = 0;
+    poll(&fd, 1, timeoutMs);
+}
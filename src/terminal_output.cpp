@@ -0,0 +1,365 @@
+#include "../include/terminal_output.h"
+#include "../include/asm_optimized.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <cerrno>
+
+// Unchanged runs shorter than this are re-sent rather than skipped with a
+// cursor move, which costs about as many bytes
+static const size_t MIN_SKIP_CELLS = 8;
+
+// Longest cursor move or DECCRA sequence we emit
+static const size_t MAX_CONTROL_BYTES = 64;
+
+static char* putNumber(char* out, unsigned value) {
+    char digits[10];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (n) {
+        *out++ = digits[--n];
+    }
+    return out;
+}
+
+static char* putCursorMove(char* out, int x, int y) {
+    *out++ = '\033';
+    *out++ = '[';
+    out = putNumber(out, y + 1);
+    *out++ = ';';
+    out = putNumber(out, x + 1);
+    *out++ = 'H';
+    return out;
+}
+
+TerminalOutput::TerminalOutput()
+    : width(0), height(0), stride(0), frameId(0), valid(false),
+      rectCopySupported(false), rectCopyEnabled(true), tileColumns(0), tileRows(0),
+      seenModCount(0), tileSkipEnabled(true), lastDiffedTiles(0), outputFd(STDOUT_FILENO), lastFrameBytes(0),
+      nonBlocking(false), backlogOffset(0), deferredFrames(0) {}
+
+void TerminalOutput::requestCapabilities() {
+    std::cout << "\033[c" << std::flush;
+}
+
+void TerminalOutput::handleDeviceAttributes(const std::vector<int>& attributes) {
+    // 28 = rectangular area operations (DECCRA and friends)
+    rectCopySupported = std::find(attributes.begin(), attributes.end(), 28) != attributes.end();
+}
+
+void TerminalOutput::copyRect(const Rect& source, int dstX, int dstY) {
+    if (source.empty() || (source.x == dstX && source.y == dstY)) return;
+    
+    PendingCopy copy;
+    copy.source = source;
+    copy.dstX = dstX;
+    copy.dstY = dstY;
+    pendingCopies.push_back(copy);
+}
+
+void TerminalOutput::resizeModel(int w, int h) {
+    width = w;
+    height = h;
+    stride = (width + 15) & ~15;
+    size_t count = (size_t)stride * height;
+    frontGlyphs.reset((uint32_t*)ASMOptimized::aligned_alloc_simd(count * sizeof(uint32_t)));
+    frontStyles.reset((StyleId*)ASMOptimized::aligned_alloc_simd(count * sizeof(StyleId)));
+    
+    tileColumns = (width + UnicodeBuffer::TILE_WIDTH - 1) / UnicodeBuffer::TILE_WIDTH;
+    tileRows = (height + UnicodeBuffer::TILE_HEIGHT - 1) / UnicodeBuffer::TILE_HEIGHT;
+    TileState unknown = { 0, false };
+    tiles.assign((size_t)tileColumns * tileRows, unknown);
+    tileChanged.assign(tiles.size(), 0);
+    valid = false;
+}
+
+void TerminalOutput::forgetTiles(const Rect& area) {
+    if (area.empty()) return;
+    int tx0 = area.x / UnicodeBuffer::TILE_WIDTH;
+    int tx1 = (area.x + area.w - 1) / UnicodeBuffer::TILE_WIDTH;
+    int ty0 = area.y / UnicodeBuffer::TILE_HEIGHT;
+    int ty1 = (area.y + area.h - 1) / UnicodeBuffer::TILE_HEIGHT;
+    for (int ty = ty0; ty <= ty1; ty++) {
+        for (int tx = tx0; tx <= tx1; tx++) {
+            tiles[(size_t)ty * tileColumns + tx].known = false;
+        }
+    }
+}
+
+void TerminalOutput::collectChangedTiles(const UnicodeBuffer& frame) {
+    size_t drawnTiles = 0;
+    for (int ty = 0; ty < tileRows; ty++) {
+        for (int tx = 0; tx < tileColumns; tx++) {
+            bool drawn = frame.getTileVersion(tx, ty) > seenModCount;
+            tileChanged[(size_t)ty * tileColumns + tx] = drawn;
+            drawnTiles += drawn;
+        }
+    }
+    
+    // Hashing costs about as much as comparing cells, so it only pays when
+    // most of the screen is untouched. Past half the tiles, drawn tiles are
+    // just compared and their hashes forgotten.
+    bool hashTiles = tileSkipEnabled && drawnTiles * 2 <= tiles.size();
+    
+    lastDiffedTiles = 0;
+    for (int ty = 0; ty < tileRows; ty++) {
+        for (int tx = 0; tx < tileColumns; tx++) {
+            size_t index = (size_t)ty * tileColumns + tx;
+            TileState& tile = tiles[index];
+            
+            bool changed = true;
+            if (!tileChanged[index] && tile.known && tileSkipEnabled) {
+                // Not drawn to since it was last emitted
+                changed = false;
+            } else if (hashTiles) {
+                uint64_t hash = frame.tileHash(tx, ty);
+                changed = !tile.known || hash != tile.hash;
+                tile.hash = hash;
+                tile.known = true;
+            } else {
+                tile.known = false;
+            }
+            tileChanged[index] = changed;
+            lastDiffedTiles += changed;
+        }
+    }
+}
+
+// Clip a copy so both its source and destination lie on screen
+static bool clipCopy(Rect& src, int& dstX, int& dstY, int width, int height) {
+    if (src.x < 0) { src.w += src.x; dstX -= src.x; src.x = 0; }
+    if (src.y < 0) { src.h += src.y; dstY -= src.y; src.y = 0; }
+    if (dstX < 0) { src.w += dstX; src.x -= dstX; dstX = 0; }
+    if (dstY < 0) { src.h += dstY; src.y -= dstY; dstY = 0; }
+    src.w = std::min(src.w, std::min(width - src.x, width - dstX));
+    src.h = std::min(src.h, std::min(height - src.y, height - dstY));
+    return !src.empty();
+}
+
+char* TerminalOutput::emitRectCopy(char* out, const PendingCopy& copy) {
+    // DECCRA: CSI Pts ; Pls ; Pbs ; Prs ; Pps ; Ptd ; Pld ; Ppd $ v (1-based, inclusive)
+    const Rect& src = copy.source;
+    *out++ = '\033';
+    *out++ = '[';
+    out = putNumber(out, src.y + 1);
+    *out++ = ';';
+    out = putNumber(out, src.x + 1);
+    *out++ = ';';
+    out = putNumber(out, src.y + src.h);
+    *out++ = ';';
+    out = putNumber(out, src.x + src.w);
+    memcpy(out, ";1;", 3);
+    out += 3;
+    out = putNumber(out, copy.dstY + 1);
+    *out++ = ';';
+    out = putNumber(out, copy.dstX + 1);
+    memcpy(out, ";1$v", 4);
+    return out + 4;
+}
+
+void TerminalOutput::applyRectCopy(const PendingCopy& copy) {
+    // Mirror the terminal: rows are walked away from the overlap and
+    // memmove handles overlap within a row
+    const Rect& src = copy.source;
+    uint32_t* glyphs = frontGlyphs.get();
+    StyleId* styles = frontStyles.get();
+    
+    for (int i = 0; i < src.h; i++) {
+        int row = copy.dstY > src.y ? src.h - 1 - i : i;
+        size_t from = (size_t)(src.y + row) * stride + src.x;
+        size_t to = (size_t)(copy.dstY + row) * stride + copy.dstX;
+        memmove(glyphs + to, glyphs + from, src.w * sizeof(uint32_t));
+        memmove(styles + to, styles + from, src.w * sizeof(StyleId));
+    }
+}
+
+char* TerminalOutput::emitFullFrame(char* out, const UnicodeBuffer& frame, int y0, int y1) {
+    // Start in the style the previous band's last row ends in, as a single
+    // pass over the frame would be
+    int currentStyle = y0 > 0 && width > 0 ? frame.styleRow(y0 - 1)[width - 1] : -1;
+    for (int y = y0; y < y1; y++) {
+        out = frame.encodeSpan(out, y, 0, width, currentStyle);
+        if (y < height - 1) {
+            memcpy(out, "\r\n", 2);
+            out += 2;
+        }
+        ASMOptimized::fast_blit_cells(frontGlyphs.get() + (size_t)y * stride, frontStyles.get() + (size_t)y * stride, stride,
+                                      frame.glyphRow(y), frame.styleRow(y), frame.getStride(),
+                                      width, 1, nullptr);
+    }
+    
+    for (int ty = y0 / UnicodeBuffer::TILE_HEIGHT; ty * UnicodeBuffer::TILE_HEIGHT < y1; ty++) {
+        for (int tx = 0; tx < tileColumns; tx++) {
+            TileState& tile = tiles[(size_t)ty * tileColumns + tx];
+            tile.hash = tileSkipEnabled ? frame.tileHash(tx, ty) : 0;
+            tile.known = tileSkipEnabled;
+        }
+    }
+    return out;
+}
+
+char* TerminalOutput::emitChangedCells(char* out, const UnicodeBuffer& frame, int y0, int y1) {
+    for (int ty = y0 / UnicodeBuffer::TILE_HEIGHT; ty * UnicodeBuffer::TILE_HEIGHT < y1; ty++) {
+        const uint8_t* changed = &tileChanged[(size_t)ty * tileColumns];
+        int rowStart = ty * UnicodeBuffer::TILE_HEIGHT;
+        int rowEnd = std::min(height, rowStart + (int)UnicodeBuffer::TILE_HEIGHT);
+        
+        // Adjacent changed tiles are diffed as one span so segments can
+        // run across tile edges
+        for (int tx = 0; tx < tileColumns; tx++) {
+            if (!changed[tx]) continue;
+            int first = tx;
+            while (tx + 1 < tileColumns && changed[tx + 1]) {
+                tx++;
+            }
+            int x0 = first * UnicodeBuffer::TILE_WIDTH;
+            int x1 = std::min(width, (tx + 1) * (int)UnicodeBuffer::TILE_WIDTH);
+            for (int y = rowStart; y < rowEnd; y++) {
+                out = emitChangedSpan(out, frame, y, x0, x1);
+            }
+        }
+    }
+    return out;
+}
+
+char* TerminalOutput::emitChangedSpan(char* out, const UnicodeBuffer& frame, int y, int x0, int x1) {
+    uint32_t* frontGlyphRow = frontGlyphs.get() + (size_t)y * stride;
+    StyleId* frontStyleRow = frontStyles.get() + (size_t)y * stride;
+    const uint32_t* glyphRow = frame.glyphRow(y);
+    const StyleId* styleRow = frame.styleRow(y);
+    size_t rowWidth = x1;
+    
+    size_t x = x0;
+    while (x < rowWidth) {
+        x += ASMOptimized::fast_cells_find_diff(frontGlyphRow + x, frontStyleRow + x,
+                                                glyphRow + x, styleRow + x, rowWidth - x);
+        if (x >= rowWidth) break;
+        
+        // Grow the segment through unchanged gaps too short to skip
+        size_t end = x + ASMOptimized::fast_cells_find_equal(frontGlyphRow + x, frontStyleRow + x,
+                                                             glyphRow + x, styleRow + x, rowWidth - x);
+        while (end < rowWidth) {
+            size_t same = ASMOptimized::fast_cells_find_diff(frontGlyphRow + end, frontStyleRow + end,
+                                                             glyphRow + end, styleRow + end, rowWidth - end);
+            if (end + same >= rowWidth || same >= MIN_SKIP_CELLS) break;
+            end += same;
+            end += ASMOptimized::fast_cells_find_equal(frontGlyphRow + end, frontStyleRow + end,
+                                                       glyphRow + end, styleRow + end, rowWidth - end);
+        }
+        
+        // Each segment starts from a reset SGR state so attributes set by
+        // an earlier segment never leak into this one
+        out = putCursorMove(out, (int)x, y);
+        memcpy(out, Color::RESET.data(), Color::RESET.size());
+        out += Color::RESET.size();
+        int currentStyle = 0;
+        out = frame.encodeSpan(out, y, (int)x, (int)end, currentStyle);
+        
+        ASMOptimized::fast_blit_cells(frontGlyphRow + x, frontStyleRow + x, stride,
+                                      glyphRow + x, styleRow + x, frame.getStride(),
+                                      end - x, 1, nullptr);
+        x = end;
+    }
+    return out;
+}
+
+void TerminalOutput::setNonBlocking(bool enabled) {
+    int flags = fcntl(outputFd, F_GETFL);
+    if (flags < 0) return;
+    fcntl(outputFd, F_SETFL, enabled ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK));
+    nonBlocking = enabled;
+    
+    // Blocking again, so this writes everything
+    if (!enabled) flush();
+}
+
+bool TerminalOutput::flush() {
+    while (backlogOffset < backlog.size()) {
+        ssize_t written = write(outputFd, backlog.data() + backlogOffset, backlog.size() - backlogOffset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return false;
+            // The terminal is gone or broken; repaint if it comes back
+            valid = false;
+            break;
+        }
+        backlogOffset += (size_t)written;
+    }
+    backlog.clear();
+    backlogOffset = 0;
+    return true;
+}
+
+bool TerminalOutput::waitWritable(int timeoutMs) const {
+    pollfd ready = { outputFd, POLLOUT, 0 };
+    return poll(&ready, 1, timeoutMs) > 0;
+}
+
+bool TerminalOutput::present(const UnicodeBuffer& frame) {
+    // Still sending an earlier frame: skip this one. Copies and drawn
+    // tiles carry over to the frame that does go out.
+    if (!flush()) {
+        deferredFrames++;
+        lastFrameBytes = 0;
+        return false;
+    }
+    
+    if (frame.getWidth() != width || frame.getHeight() != height) {
+        resizeModel(frame.getWidth(), frame.getHeight());
+    }
+    // Style ids are only comparable within one buffer's style table
+    if (frame.getInstanceId() != frameId) {
+        valid = false;
+    }
+    
+    head.clear();
+    if (!valid) {
+        head = "\033[H";
+        bands.encode(height, UnicodeBuffer::TILE_HEIGHT, (size_t)width * frame.maxEncodedCellBytes() + 2,
+                     (size_t)width * height, [&](int y0, int y1, char* out) {
+            return emitFullFrame(out, frame, y0, y1);
+        });
+        frameId = frame.getInstanceId();
+        valid = true;
+    } else {
+        if (supportsRectCopy()) {
+            for (PendingCopy copy : pendingCopies) {
+                if (clipCopy(copy.source, copy.dstX, copy.dstY, width, height)) {
+                    char sequence[MAX_CONTROL_BYTES];
+                    head.append(sequence, emitRectCopy(sequence, copy) - sequence);
+                    applyRectCopy(copy);
+                    forgetTiles(Rect(copy.dstX, copy.dstY, copy.source.w, copy.source.h));
+                }
+            }
+        }
+        
+        // Which tiles to diff is settled up front; only the diffing and
+        // encoding of their cells is split across bands.
+        // Worst case per row: every cell changed, each in its own segment.
+        collectChangedTiles(frame);
+        bands.encode(height, UnicodeBuffer::TILE_HEIGHT, (size_t)width * (frame.maxEncodedCellBytes() + MAX_CONTROL_BYTES),
+                     lastDiffedTiles * UnicodeBuffer::TILE_WIDTH * UnicodeBuffer::TILE_HEIGHT,
+                     [&](int y0, int y1, char* out) {
+            return emitChangedCells(out, frame, y0, y1);
+        });
+    }
+    pendingCopies.clear();
+    seenModCount = frame.getModCount();
+    
+    lastFrameBytes = head.size() + bands.size();
+    if (lastFrameBytes) {
+        if (nonBlocking) {
+            bands.writeAvailable(outputFd, head, Color::RESET, backlog);
+        } else {
+            bands.writeTo(outputFd, head, Color::RESET);
+        }
+        lastFrameBytes += Color::RESET.size();
+    }
+    return true;
+}
@@ -30,7 +30,8 @@ TextInput::TextInput(std::shared_ptr<Window> parent, int x, int y, int width, in
       selectionColor(Color::BLACK + Color::BG_BRIGHT_BLUE),
       maxLength(-1), passwordMode(false), passwordChar('*'), allowedChars(""), forbiddenChars(""),
       selectionStart(-1), selectionEnd(-1), hasSelection(false),
-      wasLeftPressed(false), dragging(false) {
+      dragging(false) {
+    pointer.attach(parent ? parent->id : 0, [this](const MouseEvent& event) { handlePointer(event); });
     calculateDimensions();
 }
 
@@ -38,6 +39,11 @@ void TextInput::calculateDimensions() {
     // Ensure minimum dimensions
     if (width < 3) width = 3;
     if (height < 1) height = 1;
+    placePointerTarget();
+}
+
+void TextInput::placePointerTarget() {
+    pointer.place(visible ? Rect(x, y, width, height) : Rect());
 }
 
 void TextInput::setText(const std::string& newText) {
@@ -183,6 +189,15 @@ void TextInput::setFocused(bool newFocused) {
     bool wasFocused = focused;
     focused = newFocused && enabled;
     
+    // Focus set from code moves the tracker's focus too, which blurs
+    // whatever held it; the tracker's own calls land back here as no-ops
+    PointerTracker& tracker = PointerTracker::getInstance();
+    if (focused && tracker.getFocused() != pointer.getId()) {
+        tracker.setFocus(pointer.getId());
+    } else if (!focused && tracker.getFocused() == pointer.getId()) {
+        tracker.setFocus(0);
+    }
+    
     if (focused && !wasFocused && onFocus) {
         auto event = MouseEvent(EventType::WINDOW_FOCUS, x, y);
         onFocus(event);
@@ -310,66 +325,51 @@ bool TextInput::contains(int mx, int my) const {
     return mx >= absX && mx < absX + width && my >= absY && my < absY + height;
 }
 
-void TextInput::updateMouse(FastMouseHandler& mouse, int termWidth, int termHeight) {
-    if (!visible || !parentWindow || !parentWindow->isVisible()) return;
-    
-    int mouseX = mouse.getMouseX();
-    int mouseY = mouse.getMouseY();
-    bool leftPressed = mouse.isLeftButtonPressed();
-    
-    bool isHovering = contains(mouseX, mouseY);
-    bool wasHovering = active;
-    active = isHovering;
-    
-    // Generate hover/leave events
-    if (isHovering && !wasHovering && onHover) {
-        auto event = MouseEvent(EventType::MOUSE_ENTER, mouseX, mouseY);
-        onHover(event);
-    } else if (!isHovering && wasHovering && onLeave) {
-        auto event = MouseEvent(EventType::MOUSE_LEAVE, mouseX, mouseY);
-        onLeave(event);
-    }
-    
-    if (isHovering && enabled) {
-        // Handle focus
-        if (leftPressed && !wasLeftPressed) {
+// Text position under screen column mx, accounting for the border
+int TextInput::textPositionAt(int mx) const {
+    int absX = parentWindow ? parentWindow->x + x : x;
+    return clamp_value(mx - absX - 1 + scrollOffset, 0, (int)text.length());
+}
+
+void TextInput::handlePointer(const MouseEvent& event) {
+    switch (event.type) {
+        case EventType::MOUSE_ENTER:
+            active = true;
+            if (onHover) onHover(event);
+            break;
+        case EventType::MOUSE_LEAVE:
+            active = false;
+            if (onLeave) onLeave(event);
+            break;
+        case EventType::WINDOW_FOCUS:
             setFocused(true);
-            
+            break;
+        case EventType::WINDOW_BLUR:
+            setFocused(false);
+            break;
+        case EventType::MOUSE_PRESS:
+            if (!enabled) break;
             // Position cursor based on click position
-            int absX = parentWindow->x + x;
-            int clickPos = mouseX - absX - 1; // Account for border
-            clickPos = clamp_value(clickPos + scrollOffset, 0, (int)text.length());
-            setCursorPosition(clickPos);
-            
-            if (onClick) {
-                auto event = MouseEvent(EventType::MOUSE_PRESS, mouseX, mouseY);
-                onClick(event);
-            }
-            
+            setCursorPosition(textPositionAt(event.x));
+            if (onClick) onClick(event);
             dragging = true;
             selectionStart = cursorPos;
-        }
-    } else if (leftPressed && !wasLeftPressed) {
-        // Clicked outside - lose focus
-        setFocused(false);
-    }
-    
-    // Handle text selection dragging
-    if (dragging && leftPressed && enabled && focused) {
-        int absX = parentWindow->x + x;
-        int dragPos = mouseX - absX - 1; // Account for border
-        dragPos = clamp_value(dragPos + scrollOffset, 0, (int)text.length());
-        
-        if (dragPos != selectionStart) {
-            selectRange(selectionStart, dragPos);
-        }
-    }
-    
-    if (!leftPressed && wasLeftPressed) {
-        dragging = false;
+            break;
+        case EventType::MOUSE_DRAG:
+            // Handle text selection dragging
+            if (dragging && enabled && focused) {
+                int dragPos = textPositionAt(event.x);
+                if (dragPos != selectionStart) {
+                    selectRange(selectionStart, dragPos);
+                }
+            }
+            break;
+        case EventType::MOUSE_RELEASE:
+            dragging = false;
+            break;
+        default:
+            break;
     }
-    
-    wasLeftPressed = leftPressed;
 }
 
 void TextInput::handleKeyboard(char ch, int keyCode) {
@@ -400,22 +400,18 @@ void TextInput::handleKeyboard(char ch, int keyCode) {
 void TextInput::draw(UnicodeBuffer& buffer) {
     if (!visible || !parentWindow || !parentWindow->isVisible()) return;
     
-    int absX = parentWindow->x + x;
-    int absY = parentWindow->y + y;
+    // Draw in field-local coordinates through a view of the field's area
+    BufferView view = parentWindow->view(buffer).subView(Rect(x, y, width, height));
     
     // Determine border color
     std::string currentBorderColor = focused ? focusedBorderColor : borderColor;
     
     // Draw border
-    for (int row = 0; row < height; row++) {
-        buffer.setCell(absX, absY + row, "|", currentBorderColor);
-        buffer.setCell(absX + width - 1, absY + row, "|", currentBorderColor);
-        
-        // Fill background
-        for (int col = 1; col < width - 1; col++) {
-            buffer.setCell(absX + col, absY + row, backgroundFill, textColor);
-        }
-    }
+    view.drawVLine(0, 0, height, "|", currentBorderColor);
+    view.drawVLine(width - 1, 0, height, "|", currentBorderColor);
+    
+    // Fill background
+    view.fillRect(1, 0, width - 2, height, backgroundFill, textColor);
     
     // Draw text content
     std::string visibleText = getVisibleText();
@@ -423,7 +419,7 @@ void TextInput::draw(UnicodeBuffer& buffer) {
     std::string displayColor = text.empty() && !focused ? placeholderColor : textColor;
     
     if (!displayText.empty()) {
-        buffer.drawStringClipped(absX + 1, absY, displayText, displayColor, absX + width - 1);
+        view.drawStringClipped(1, 0, displayText, displayColor, width - 1);
     }
     
     // Draw selection
@@ -434,18 +430,18 @@ void TextInput::draw(UnicodeBuffer& buffer) {
         for (int i = visibleSelStart; i < visibleSelEnd; i++) {
             if (i >= 0 && i < (int)visibleText.length()) {
                 std::string ch = visibleText.substr(i, 1);
-                buffer.setCell(absX + 1 + i, absY, ch, selectionColor);
+                view.setCell(1 + i, 0, ch, selectionColor);
             }
         }
     }
     
     // Draw cursor
     if (focused && !hasSelection) {
-        int cursorX = absX + 1 + (cursorPos - scrollOffset);
-        if (cursorX >= absX + 1 && cursorX < absX + width - 1) {
+        int cursorX = 1 + (cursorPos - scrollOffset);
+        if (cursorX >= 1 && cursorX < width - 1) {
             std::string cursorChar = (cursorPos < (int)visibleText.length()) ? 
                                    visibleText.substr(cursorPos - scrollOffset, 1) : " ";
-            buffer.setCell(cursorX, absY, cursorChar, cursorColor);
+            view.setCell(cursorX, 0, cursorChar, cursorColor);
         }
     }
 }
@@ -3,18 +3,36 @@
 #include <termios.h>
 #include <signal.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <algorithm>
 
-TUIApplication::TUIApplication() : buffer(nullptr), frame(0), 
-    current_cursor_type(CursorType::DEFAULT), last_mouse_x(-1), last_mouse_y(-1), mouse_moved(false) {
-    setupTerminal();
-    updateTerminalSize();
+TUIApplication::TUIApplication(bool headless) : buffer(nullptr), frame(0), fullDamage(true), pointer(PointerTracker::getInstance()),
+    headless(headless), nullFd(-1), current_cursor_type(CursorType::DEFAULT), last_mouse_x(-1), last_mouse_y(-1), mouse_moved(false) {
+    if (headless) {
+        // Frames are still diffed and encoded, just not shown
+        term_width = 80;
+        term_height = 24;
+        nullFd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+        output.setOutputFd(nullFd);
+    } else {
+        setupTerminal();
+        updateTerminalSize();
+    }
     buffer = new UnicodeBuffer(term_width, term_height);
-    mouse.enableMouse();
+    pointer.resize(term_width, term_height);
+    windows.setScreen(term_width, term_height);
+    if (!headless) {
+        mouse.enableMouse();
+        output.requestCapabilities();
+    }
 }
 
 TUIApplication::~TUIApplication() {
+    presenter.reset();
     delete buffer;
+    mouse.setRecorder(nullptr);
+    recorder.close();
+    if (nullFd >= 0) close(nullFd);
     restoreTerminal();
 }
 
@@ -43,6 +61,8 @@ void TUIApplication::setupTerminal() {
 
 void TUIApplication::restoreTerminal() {
     if (terminal_initialized) {
+        // Sends what is left of the last frame, then the reset below
+        output.setNonBlocking(false);
         std::cout << "\033[?1003l\033[?1006l\033[?1000l\033[?25h\033[2J\033[H\033[0m" << std::flush;
         tcsetattr(STDIN_FILENO, TCSAFLUSH, &orig_termios);
         terminal_initialized = false;
@@ -60,9 +80,93 @@ void TUIApplication::updateTerminalSize() {
 }
 
 void TUIApplication::drawBackground() {
-    for (int y = 0; y < term_height; y++) {
-        for (int x = 0; x < term_width; x++) {
-            buffer->setCell(x, y, " ", Color::WHITE + Color::BG_BLUE);
+    // Only damaged cells no window covers; compositeWindows() has filled `coverage`
+    visibleRects.clear();
+    coverage.subtractFrom(Rect(0, 0, term_width, term_height), visibleRects);
+    damagedRects.clear();
+    for (const Rect& r : visibleRects) {
+        damage.intersectFrom(r, damagedRects);
+    }
+    for (const Rect& r : damagedRects) {
+        buffer->fillRect(r.x, r.y, r.w, r.h, " ", Color::WHITE + Color::BG_BLUE);
+    }
+}
+
+void TUIApplication::fillBackground() {
+    buffer->fillRect(0, 0, term_width, term_height, " ", Color::WHITE + Color::BG_BLUE);
+}
+
+void TUIApplication::collectDamage() {
+    damage.reset(term_width, term_height);
+    if (fullDamage) {
+        damage.addRect(Rect(0, 0, term_width, term_height));
+        fullDamage = false;
+    }
+    
+    // A window that moved, resized or changed stacking damages both where
+    // it was (with its shadow) and where it is now; one whose layer will
+    // repaint damages just its current bounds
+    size_t rank = 0;
+    for (WindowManager::Handle h = windows.bottomLive(); h; h = windows.liveAbove(h), rank++) {
+        const Window& window = *windows.get(h);
+        Rect bounds = window.getBounds();
+        
+        auto previous = compositedIndex.find(window.id);
+        if (previous == compositedIndex.end()) {
+            damage.addRect(bounds);
+        } else if (previous->second != rank || composited[previous->second].bounds != bounds) {
+            damage.addRect(composited[previous->second].bounds);
+            damage.addRect(bounds);
+        } else if (window.layerNeedsRepaint()) {
+            damage.addRect(bounds);
+        }
+    }
+    
+    // Windows hidden, culled or removed since the last frame uncover what
+    // was beneath them
+    for (const CompositedWindow& entry : composited) {
+        if (!windows.isLive(windows.find(entry.id))) {
+            damage.addRect(entry.bounds);
+        }
+    }
+    
+    composited.clear();
+    compositedIndex.clear();
+    for (WindowManager::Handle h = windows.bottomLive(); h; h = windows.liveAbove(h)) {
+        const Window& window = *windows.get(h);
+        CompositedWindow entry;
+        entry.id = window.id;
+        entry.bounds = window.getBounds();
+        compositedIndex[entry.id] = composited.size();
+        composited.push_back(entry);
+    }
+}
+
+void TUIApplication::compositeWindows() {
+    // Front to back: each window gets whatever of its footprint the windows
+    // above it left uncovered, so nothing is drawn twice and fully hidden
+    // windows are skipped
+    coverage.reset(term_width, term_height);
+    for (WindowManager::Handle h = windows.topLive(); h; h = windows.liveBelow(h)) {
+        Window& window = *windows.get(h);
+        
+        footprint.clear();
+        window.getFootprint(footprint);
+        
+        visibleRects.clear();
+        for (const Rect& r : footprint) {
+            coverage.subtractFrom(r, visibleRects);
+        }
+        
+        // Undamaged cells still hold last frame's composite
+        damagedRects.clear();
+        for (const Rect& r : visibleRects) {
+            damage.intersectFrom(r, damagedRects);
+        }
+        window.drawCached(*buffer, damagedRects);
+        
+        for (const Rect& r : footprint) {
+            coverage.addRect(r);
         }
     }
 }
@@ -82,28 +186,81 @@ void TUIApplication::drawStatusBar() {
     }
 }
 
-void TUIApplication::addWindow(std::shared_ptr<Window> window) {
-    windows.push_back(window);
+WindowManager::Handle TUIApplication::addWindow(std::shared_ptr<Window> window) {
+    uint32_t id = window->id;
+    Window* target = window.get();
+    WindowManager::Handle handle = windows.add(std::move(window));
+    
+    // Windows scroll their content with the wheel unless a scrollable
+    // widget inside them is under the pointer
+    pointer.addTarget(id, 0, [target](const MouseEvent& event) {
+        if (event.type == EventType::MOUSE_WHEEL) target->scrollBy(event.deltaX, event.deltaY);
+    });
+    pointer.setScrollable(id, true);
+    updateHitTargets();
+    return handle;
 }
 
 void TUIApplication::removeWindow(std::shared_ptr<Window> window) {
-    windows.erase(std::remove(windows.begin(), windows.end(), window), windows.end());
+    windows.remove(windows.find(window->id));
+    pointer.removeTarget(window->id);
+    updateHitTargets();
+}
+
+void TUIApplication::updateWindows() {
+    for (WindowManager::Handle h = windows.topLive(); h; h = windows.liveBelow(h)) {
+        windows.get(h)->active = false;
+    }
+    
+    for (WindowManager::Handle h = windows.topLive(); h; h = windows.liveBelow(h)) {
+        Window& window = *windows.get(h);
+        window.updateMouse(mouse, term_width, term_height);
+        if (window.dragging || window.resizing) {
+            window.active = true;
+            windows.raise(h);
+            break;
+        }
+    }
+    
+    // Closing or dragging may have taken windows off screen
+    windows.refreshLive();
 }
 
 void TUIApplication::run() {
+    bool capabilitiesApplied = false;
+    
     while (true) {
-        mouse.updateMouse();
+        if (replaying) {
+            if (!feedReplay()) break;
+        } else {
+            mouse.updateMouse();
+        }
+        if (!capabilitiesApplied && mouse.hasDeviceAttributes()) {
+            if (presenter) {
+                presenter->handleDeviceAttributes(mouse.getDeviceAttributes());
+            } else {
+                output.handleDeviceAttributes(mouse.getDeviceAttributes());
+            }
+            capabilitiesApplied = true;
+        }
         
-        // Update terminal size in case it changed
-        updateTerminalSize();
-        if (buffer) {
+        // Updates posted from other threads since the last frame
+        tasks.drain();
+        
+        // Update terminal size in case it changed; the screen buffer (and its
+        // interned styles) is only rebuilt when the size actually changes
+        if (!replaying && !headless) {
+            updateTerminalSize();
+        }
+        if (!buffer || buffer->getWidth() != term_width || buffer->getHeight() != term_height) {
             delete buffer;
             buffer = new UnicodeBuffer(term_width, term_height);
+            pointer.resize(term_width, term_height);
+            windows.setScreen(term_width, term_height);
+            recorder.recordResize(term_width, term_height);
+            fullDamage = true;
         }
         
-        buffer->clear();
-        drawBackground();
-        
         // Track mouse movement
         int current_mouse_x = mouse.getMouseX();
         int current_mouse_y = mouse.getMouseY();
@@ -111,43 +268,57 @@ void TUIApplication::run() {
         last_mouse_x = current_mouse_x;
         last_mouse_y = current_mouse_y;
         
-        // Reset window states
-        for (auto& window : windows) {
-            window->active = false;
+        // A window already being dragged is on top, so last frame shows it
+        // intact at its old position
+        WindowManager::Handle draggedHandle = windows.topLive();
+        Window* dragged = nullptr;
+        int dragFromX = 0, dragFromY = 0;
+        if (draggedHandle && windows.get(draggedHandle)->dragging) {
+            dragged = windows.get(draggedHandle);
+            dragFromX = dragged->x;
+            dragFromY = dragged->y;
         }
         
-        // Update windows in reverse order (top window gets priority)
-        for (int i = windows.size() - 1; i >= 0; i--) {
-            if (windows[i]->isVisible()) {
-                windows[i]->updateMouse(mouse, term_width, term_height);
-                if (windows[i]->dragging || windows[i]->resizing) {
-                    windows[i]->active = true;
-                    // Move active window to front
-                    if (i != windows.size() - 1) {
-                        auto temp = windows[i];
-                        windows.erase(windows.begin() + i);
-                        windows.push_back(temp);
-                    }
-                    break;
-                }
-            }
-        }
+        updateWindows();
+        
+        // Widgets hear about hover, press and focus changes from here, not
+        // by polling the mouse themselves
+        updateHitTargets();
+        pointer.update(current_mouse_x, current_mouse_y, mouse.isLeftButtonPressed());
+        pointer.wheel(mouse.getWheelDeltaX(), mouse.getWheelDeltaY());
         
-        // Draw all visible windows
-        for (auto& window : windows) {
-            if (window->isVisible()) {
-                window->draw(*buffer);
+        // Shift the dragged window's body on the terminal instead of
+        // repainting it; the diff then fixes the exposed strip
+        if (dragged && windows.isLive(draggedHandle) && dragged->dragging &&
+            (dragged->x != dragFromX || dragged->y != dragFromY)) {
+            Rect source(dragFromX, dragFromY, dragged->w, dragged->h);
+            if (presenter) {
+                presenter->copyRect(source, dragged->x, dragged->y);
+            } else {
+                output.copyRect(source, dragged->x, dragged->y);
             }
         }
         
+        // Composite cached window layers into the damaged, unoccluded parts
+        // of the screen; only windows whose state changed are re-rasterized
+        collectDamage();
+        compositeWindows();
+        drawBackground();
+        
         // Draw enhanced mouse cursor (always on top)
         drawMouseCursor();
         
         drawStatusBar();
-        buffer->render();
+        if (presenter) {
+            presenter->submit(*buffer);
+        } else {
+            output.present(*buffer);
+        }
         
         frame++;
-        usleep(16000); // ~60 FPS
+        // ~60 FPS, sooner when something was posted; a replay that is not
+        // paced in real time only picks up posted tasks
+        tasks.wait(replaying && !replaying->isRealTime() ? 0 : 16);
     }
 }
 
@@ -157,35 +328,108 @@ void TUIApplication::drawMouseCursor() {
 }
 
 CursorType TUIApplication::determineCursorType(int mouse_x, int mouse_y) {
-    // Check if mouse is over any interactive elements
-    for (auto& window : windows) {
-        if (!window->isVisible()) continue;
-        
-        // Check if over close button
-        if (window->closeButtonContains(mouse_x, mouse_y)) {
-            return CursorType::HAND;
-        }
-        
-        // Check if over resize handle
-        if (window->resizeHandleContains(mouse_x, mouse_y)) {
-            return CursorType::RESIZE;
-        }
-        
-        // Check if over title bar (draggable area)
-        if (window->titleContains(mouse_x, mouse_y)) {
-            return CursorType::MOVE;
-        }
-        
-        // Check if over window content
-        if (window->contains(mouse_x, mouse_y)) {
-            return CursorType::POINTER;
-        }
+    // Only the window on top at the pointer can be under it
+    Window* window = windowAt(mouse_x, mouse_y);
+    if (!window) {
+        return CursorType::DEFAULT;
+    }
+    
+    // Check if over close button
+    if (window->closeButtonContains(mouse_x, mouse_y)) {
+        return CursorType::HAND;
+    }
+    
+    // Check if over resize handle
+    if (window->resizeHandleContains(mouse_x, mouse_y)) {
+        return CursorType::RESIZE;
+    }
+    
+    // Check if over title bar (draggable area)
+    if (window->titleContains(mouse_x, mouse_y)) {
+        return CursorType::MOVE;
+    }
+    
+    return CursorType::POINTER;
+}
+
+void TUIApplication::updateHitTargets() {
+    // Windows that left the live list can no longer be hit
+    culledWindows.clear();
+    windows.takeCulled(culledWindows);
+    for (uint32_t id : culledWindows) {
+        pointer.setTargetRect(id, Rect());
+    }
+    
+    // setTargetRect() returns early for windows that did not change
+    uint32_t depth = 0;
+    for (WindowManager::Handle h = windows.bottomLive(); h; h = windows.liveAbove(h), depth++) {
+        const Window& window = *windows.get(h);
+        pointer.setTargetRect(window.id, Rect(window.x, window.y, window.w, window.h), depth);
+    }
+}
+
+Window* TUIApplication::windowAt(int x, int y) const {
+    // The pick buffer answers with what the last frame showed at the cell,
+    // shadows and popups included; owners that are not windows find no handle
+    uint32_t id = UnicodeBuffer::hasPickBuffer() ? buffer->ownerAt(x, y) : pointer.topLevelAt(x, y);
+    return windows.get(windows.find(id));
+}
+
+void TUIApplication::setPresentThreadEnabled(bool enabled) {
+    if (enabled && !presenter) {
+        presenter.reset(new PresentThread(output));
+    } else if (!enabled) {
+        // Joins after the last submitted frame is out
+        presenter.reset();
+    }
+}
+
+bool TUIApplication::startRecording(const std::string& path) {
+    if (!recorder.open(path)) return false;
+    recorder.recordResize(term_width, term_height);
+    mouse.setRecorder(&recorder);
+    return true;
+}
+
+void TUIApplication::stopRecording() {
+    mouse.setRecorder(nullptr);
+    recorder.close();
+}
+
+bool TUIApplication::replay(const std::string& path, bool realTime) {
+    std::unique_ptr<InputReplay> recording(new InputReplay());
+    if (!recording->open(path)) return false;
+    recording->start(realTime);
+    replaying = std::move(recording);
+    return true;
+}
+
+bool TUIApplication::feedReplay() {
+    if (replaying->finished()) {
+        replaying.reset();
+        return false;
     }
     
-    // Default cursor for empty areas
-    return CursorType::DEFAULT;
+    mouse.beginFrame();
+    replaying->advance();
+    while (const InputRecord* record = replaying->next()) {
+        if (record->kind == InputRecord::MOUSE) {
+            mouse.injectMouseEvent(record->mouse);
+        } else {
+            term_width = record->width;
+            term_height = record->height;
+        }
+    }
+    return true;
+}
+
+void TUIApplication::setNonBlockingOutput(bool enabled) {
+    if (presenter) presenter->waitIdle();
+    output.setNonBlocking(enabled);
 }
 
 void TUIApplication::quit() {
+    // Let the last frame finish before the terminal is restored
+    presenter.reset();
     cleanup(0);
 }
\ No newline at end of file
@@ -3,8 +3,19 @@
 #include "../include/buffer.h"
 #include <algorithm>
 
+WindowEvent::WindowEvent(EventType type, std::shared_ptr<Window> window, int x, int y, int width, int height)
+    : Event(type), window(window), x(x), y(y), width(width), height(height),
+      prevX(x), prevY(y), prevWidth(width), prevHeight(height) {
+}
+
+ScrollEvent::ScrollEvent(EventType type, std::shared_ptr<Window> window, int scrollX, int scrollY,
+                         int deltaX, int deltaY, bool vertical)
+    : Event(type), window(window), scrollX(scrollX), scrollY(scrollY),
+      deltaX(deltaX), deltaY(deltaY), vertical(vertical) {
+}
+
 Window::Window(int x, int y, int w, int h, const std::string& title)
-    : x(x), y(y), w(w), h(h), title(title), active(false), dragging(false), 
+    : id(UnicodeBuffer::allocateOwnerId()), x(x), y(y), w(w), h(h), title(title), active(false), dragging(false), 
       resizing(false), visible(true), dragOffsetX(0), dragOffsetY(0), 
       moveCount(0), resizeCount(0), scrollX(0), scrollY(0), 
       contentWidth(0), contentHeight(0), enableScrollbars(true),
@@ -40,31 +51,20 @@ void Window::draw(UnicodeBuffer& buffer) {
     contentColor = Color::BLACK + Color::BG_WHITE;
     shadowColor = Color::BLACK + Color::BG_BLACK;
     
-    // Draw solid black shadow directly adjacent to window (no gap)
-    // Right edge shadow
-    for (int i = 1; i < h; i++) {
-        if (x + w < 200 && y + i < 100) {
-            buffer.setCell(x + w, y + i, Unicode::FULL_BLOCK, shadowColor);
-        }
-    }
-    // Bottom edge shadow
-    for (int i = 1; i < w; i++) {
-        if (x + i < 200 && y + h < 100) {
-            buffer.setCell(x + i, y + h, Unicode::FULL_BLOCK, shadowColor);
-        }
-    }
-    // Bottom-right corner shadow
-    if (x + w < 200 && y + h < 100) {
-        buffer.setCell(x + w, y + h, Unicode::FULL_BLOCK, shadowColor);
-    }
+    // Cells drawn from here on, shadow included, pick as this window
+    uint32_t previousOwner = buffer.getOwner();
+    buffer.setOwner(id);
+    
+    // Draw solid black shadow directly adjacent to window (no gap):
+    // right edge including the corner, then the bottom edge
+    buffer.drawVLine(x + w, y + 1, h, Unicode::FULL_BLOCK, shadowColor);
+    buffer.drawHLine(x + 1, y + h, w - 1, Unicode::FULL_BLOCK, shadowColor);
     
     // Draw main window box with style variations
     buffer.drawBox(x, y, w, h, borderColor, rounded, heavy);
     
     // Title bar background
-    for (int i = 1; i < w - 1; i++) {
-        buffer.setCell(x + i, y, " ", titleBgColor);
-    }
+    buffer.drawHLine(x + 1, y, w - 2, " ", titleBgColor);
     
     // Window title with Unicode elements
     std::string displayTitle = resizing ? " " + Unicode::RESIZE_HANDLE + " " + title + " " : 
@@ -85,21 +85,13 @@ void Window::draw(UnicodeBuffer& buffer) {
     buffer.setCell(x + w - 3, y, Unicode::FULL_BLOCK, Color::BRIGHT_RED + Color::BG_RED);
     buffer.setCell(x + w - 2, y, "]", titleFgColor + titleBgColor);
     
-    // Calculate content area dimensions (account for scrollbars)
-    int contentAreaWidth = w - 2;  // Account for left/right borders
-    int contentAreaHeight = h - 2; // Account for top/bottom borders
-    
-    if (needsVerticalScrollbar()) contentAreaWidth--;
-    if (needsHorizontalScrollbar()) contentAreaHeight--;
+    // Content area inside the border, short of the scrollbars
+    const Layout& box = getLayout();
+    int contentAreaWidth = box.content.w;
+    int contentAreaHeight = box.content.h;
     
     // Content area background (stop before borders and scrollbars)
-    for (int row = 1; row < h - 1; row++) {
-        for (int col = 1; col < w - 1; col++) {
-            if (needsVerticalScrollbar() && col == w - 2) continue;   // Skip vertical scrollbar column
-            if (needsHorizontalScrollbar() && row == h - 2) continue; // Skip horizontal scrollbar row
-            buffer.setCell(x + col, y + row, " ", contentColor);
-        }
-    }
+    buffer.fillRect(x + box.content.x, y + box.content.y, contentAreaWidth, contentAreaHeight, " ", contentColor);
     
     // Draw scrollable content
     if (!content.empty()) {
@@ -139,8 +131,8 @@ void Window::draw(UnicodeBuffer& buffer) {
         // Debug scrollbar info
         if (h > 8) {
             std::string debugInfo = "Content: " + std::to_string(contentWidth) + "x" + std::to_string(contentHeight) + 
-                                   " V:" + (needsVerticalScrollbar() ? "Y" : "N") + 
-                                   " H:" + (needsHorizontalScrollbar() ? "Y" : "N");
+                                   " V:" + (box.hasVertical ? "Y" : "N") + 
+                                   " H:" + (box.hasHorizontal ? "Y" : "N");
             buffer.drawStringClipped(x + 2, y + h - 4, debugInfo, Color::BRIGHT_YELLOW + Color::BG_BLUE, x + w - 2);
         }
     }
@@ -159,6 +151,87 @@ void Window::draw(UnicodeBuffer& buffer) {
     if (w > 6 && h > 3) {
         buffer.setCell(x + w - 1, y + h - 1, Unicode::RESIZE_HANDLE, borderColor);
     }
+    
+    buffer.setOwner(previousOwner);
+}
+
+bool Window::LayerKey::operator==(const LayerKey& other) const {
+    return w == other.w && h == other.h && active == other.active &&
+           dragging == other.dragging && resizing == other.resizing &&
+           enableScrollbars == other.enableScrollbars &&
+           scrollX == other.scrollX && scrollY == other.scrollY &&
+           moveCount == other.moveCount && resizeCount == other.resizeCount &&
+           contentWidth == other.contentWidth && contentHeight == other.contentHeight &&
+           title == other.title;
+}
+
+Window::LayerKey Window::currentLayerKey() const {
+    LayerKey key;
+    key.w = w;
+    key.h = h;
+    key.active = active;
+    key.dragging = dragging;
+    key.resizing = resizing;
+    key.enableScrollbars = enableScrollbars;
+    key.scrollX = scrollX;
+    key.scrollY = scrollY;
+    // The counters appear only in the default content, so dragging a
+    // window with content moves the cached layer without repainting it
+    key.moveCount = content.empty() && h > 5 ? moveCount : 0;
+    key.resizeCount = content.empty() && h > 6 ? resizeCount : 0;
+    key.contentWidth = contentWidth;
+    key.contentHeight = contentHeight;
+    key.title = title;
+    return key;
+}
+
+void Window::getFootprint(std::vector<Rect>& rects) const {
+    rects.push_back(Rect(x, y, w, h));
+    rects.push_back(Rect(x + w, y + 1, 1, h));
+    rects.push_back(Rect(x + 1, y + h, w - 1, 1));
+}
+
+BufferView Window::view(UnicodeBuffer& buffer) const {
+    return buffer.view(Rect(x, y, w, h)).clipped(Rect(1, 1, w - 2, h - 2));
+}
+
+bool Window::layerNeedsRepaint() const {
+    return layerDirty || !layer || layer->getWidth() != w + 1 || layer->getHeight() != h + 1 ||
+           !(currentLayerKey() == layerKey);
+}
+
+void Window::drawCached(UnicodeBuffer& screen) {
+    std::vector<Rect> footprint;
+    getFootprint(footprint);
+    drawCached(screen, footprint);
+}
+
+void Window::drawCached(UnicodeBuffer& screen, const std::vector<Rect>& visibleRects) {
+    // Fully occluded: leave the layer (and its widgets) untouched until it shows again
+    if (!visible || visibleRects.empty()) return;
+    
+    // The layer covers the window plus the one-cell shadow to the right and below
+    if (!layer || layer->getWidth() != w + 1 || layer->getHeight() != h + 1) {
+        layer.reset(new UnicodeBuffer(w + 1, h + 1));
+        layerDirty = true;
+    }
+    
+    LayerKey key = currentLayerKey();
+    if (layerDirty || !(key == layerKey)) {
+        // Widgets draw in screen coordinates, so anchor the layer at our position
+        layer->clear();
+        layer->pushTranslation(-x, -y);
+        draw(*layer);
+        layer->pop();
+        layerKey = key;
+        layerDirty = false;
+    }
+    
+    // Visible rects lie within the footprint, so the two layer corners the
+    // shadow doesn't cover stay transparent
+    for (const Rect& r : visibleRects) {
+        screen.blit(*layer, r.x - x, r.y - y, r.w, r.h, r.x, r.y);
+    }
 }
 
 bool Window::titleContains(int mx, int my) const {
@@ -219,24 +292,12 @@ void Window::updateMouse(FastMouseHandler& mouse, int termWidth, int termHeight)
             // Start dragging vertical thumb
             active = true;
             draggingVerticalThumb = true;
-            int scrollbarHeight = h - 2 - (needsHorizontalScrollbar() ? 1 : 0);
-            int trackHeight = scrollbarHeight - 1;
-            int thumbPos = 1;
-            if (contentHeight > trackHeight) {
-                thumbPos = 1 + (scrollY * (trackHeight - 1)) / std::max(1, contentHeight - trackHeight);
-            }
-            dragThumbOffset = mouseY - (y + 1 + thumbPos);
+            dragThumbOffset = mouseY - (y + getLayout().verticalThumb.y);
         } else if (horizontalThumbContains(mouseX, mouseY)) {
             // Start dragging horizontal thumb
             active = true;
             draggingHorizontalThumb = true;
-            int scrollbarWidth = w - 2 - (needsVerticalScrollbar() ? 1 : 0);
-            int trackWidth = scrollbarWidth - 1;
-            int thumbPos = 1;
-            if (contentWidth > trackWidth) {
-                thumbPos = 1 + (scrollX * (trackWidth - 1)) / std::max(1, contentWidth - trackWidth);
-            }
-            dragThumbOffset = mouseX - (x + 1 + thumbPos);
+            dragThumbOffset = mouseX - (x + getLayout().horizontalThumb.x);
         } else if (verticalScrollbarContains(mouseX, mouseY) || horizontalScrollbarContains(mouseX, mouseY)) {
             // Handle scrollbar button/track clicks
             active = true;
@@ -298,11 +359,13 @@ void Window::setContent(const std::vector<std::string>& newContent) {
     calculateContentDimensions();
     scrollX = 0;
     scrollY = 0;
+    invalidate();
 }
 
 void Window::addContentLine(const std::string& line) {
     content.push_back(line);
     calculateContentDimensions();
+    invalidate();
 }
 
 void Window::clearContent() {
@@ -311,6 +374,7 @@ void Window::clearContent() {
     contentHeight = 0;
     scrollX = 0;
     scrollY = 0;
+    invalidate();
 }
 
 void Window::calculateContentDimensions() {
@@ -328,9 +392,7 @@ void Window::scrollUp(int lines) {
 }
 
 void Window::scrollDown(int lines) {
-    int availableHeight = h - 2; // Account for borders
-    if (needsHorizontalScrollbar()) availableHeight--; // Account for horizontal scrollbar
-    int maxScrollY = std::max(0, contentHeight - availableHeight);
+    int maxScrollY = std::max(0, contentHeight - getLayout().content.h);
     scrollY = std::min(maxScrollY, scrollY + lines);
 }
 
@@ -339,27 +401,119 @@ void Window::scrollLeft(int chars) {
 }
 
 void Window::scrollRight(int chars) {
-    int availableWidth = w - 2; // Account for borders
-    if (needsVerticalScrollbar()) availableWidth--; // Account for vertical scrollbar
-    int maxScrollX = std::max(0, contentWidth - availableWidth);
+    int maxScrollX = std::max(0, contentWidth - getLayout().content.w);
     scrollX = std::min(maxScrollX, scrollX + chars);
 }
 
+void Window::scrollBy(int dx, int dy) {
+    int oldScrollX = scrollX;
+    int oldScrollY = scrollY;
+    
+    if (dy < 0) scrollUp(-dy);
+    else if (dy > 0) scrollDown(dy);
+    if (dx < 0) scrollLeft(-dx);
+    else if (dx > 0) scrollRight(dx);
+    
+    generateScrollEvents(oldScrollX, oldScrollY);
+}
+
 // Scrollbar helper methods
 bool Window::needsVerticalScrollbar() const {
-    if (!enableScrollbars || content.empty()) return false;
-    // Check if content height exceeds available space, assuming horizontal scrollbar might exist
-    int availableHeight = h - 2; // Account for top/bottom borders
-    if (contentWidth > (w - 3)) availableHeight--; // Reserve space for horizontal scrollbar (need 3 chars: borders + scrollbar)
-    return contentHeight > availableHeight;
+    return getLayout().hasVertical;
 }
 
 bool Window::needsHorizontalScrollbar() const {
-    if (!enableScrollbars || content.empty()) return false;
-    // Check if content width exceeds available space, assuming vertical scrollbar might exist
-    int availableWidth = w - 2; // Account for left/right borders
-    if (contentHeight > (h - 3)) availableWidth--; // Reserve space for vertical scrollbar (need 3 chars: borders + scrollbar)
-    return contentWidth > availableWidth;
+    return getLayout().hasHorizontal;
+}
+
+bool Window::LayoutKey::operator==(const LayoutKey& other) const {
+    return w == other.w && h == other.h &&
+           contentWidth == other.contentWidth && contentHeight == other.contentHeight &&
+           scrollX == other.scrollX && scrollY == other.scrollY &&
+           enableScrollbars == other.enableScrollbars && hasContent == other.hasContent;
+}
+
+const Window::Layout& Window::getLayout() const {
+    LayoutKey key;
+    key.w = w;
+    key.h = h;
+    key.contentWidth = contentWidth;
+    key.contentHeight = contentHeight;
+    key.scrollX = scrollX;
+    key.scrollY = scrollY;
+    key.enableScrollbars = enableScrollbars;
+    key.hasContent = !content.empty();
+    
+    if (!layoutValid || !(key == layoutKey)) {
+        layoutKey = key;
+        computeLayout();
+        layoutValid = true;
+    }
+    return layout;
+}
+
+void Window::computeLayout() const {
+    Layout& l = layout;
+    l.hasVertical = l.hasHorizontal = false;
+    if (enableScrollbars && !content.empty()) {
+        // Each check assumes the other bar might take its line
+        // (need 3 chars: borders + scrollbar)
+        int availableHeight = h - 2; // Account for top/bottom borders
+        if (contentWidth > (w - 3)) availableHeight--;
+        l.hasVertical = contentHeight > availableHeight;
+        
+        int availableWidth = w - 2; // Account for left/right borders
+        if (contentHeight > (h - 3)) availableWidth--;
+        l.hasHorizontal = contentWidth > availableWidth;
+    }
+    l.content = Rect(1, 1, w - 2 - (l.hasVertical ? 1 : 0), h - 2 - (l.hasHorizontal ? 1 : 0));
+    
+    l.verticalBar = l.horizontalBar = Rect();
+    l.verticalThumb = l.horizontalThumb = Rect();
+    l.verticalTrack = l.horizontalTrack = 0;
+    l.verticalMaxThumb = l.horizontalMaxThumb = 0;
+    
+    // Each bar is an arrow button at either end with the track between.
+    // The thumb position is 1-based from the first button, so a thumb at
+    // the top of the track sits at 1. A bar with no room between its
+    // buttons keeps its line but is neither drawn nor hit-tested.
+    if (l.hasVertical) {
+        int scrollbarHeight = l.content.h;
+        if (scrollbarHeight > 2) {
+            int trackHeight = scrollbarHeight - 1;
+            l.verticalBar = Rect(w - 2, 1, 1, scrollbarHeight);
+            l.verticalTrack = trackHeight;
+            
+            int thumbSize = std::max(1, std::min(trackHeight - 1, (trackHeight * trackHeight) / contentHeight));
+            int maxThumbPos = trackHeight - 1 - thumbSize;
+            int thumbPos = 1;
+            if (contentHeight > trackHeight && maxThumbPos > 0) {
+                thumbPos = 1 + (scrollY * maxThumbPos) / std::max(1, contentHeight - trackHeight);
+                thumbPos = std::max(1, std::min(trackHeight - thumbSize, thumbPos));
+            }
+            l.verticalMaxThumb = maxThumbPos;
+            l.verticalThumb = Rect(w - 2, 1 + thumbPos, 1, thumbSize);
+        }
+    }
+    
+    if (l.hasHorizontal) {
+        int scrollbarWidth = l.content.w;
+        if (scrollbarWidth > 2) {
+            int trackWidth = scrollbarWidth - 1;
+            l.horizontalBar = Rect(1, h - 2, scrollbarWidth, 1);
+            l.horizontalTrack = trackWidth;
+            
+            int thumbSize = std::max(1, std::min(trackWidth - 1, (trackWidth * trackWidth) / contentWidth));
+            int maxThumbPos = trackWidth - 1 - thumbSize;
+            int thumbPos = 1;
+            if (contentWidth > trackWidth && maxThumbPos > 0) {
+                thumbPos = 1 + (scrollX * maxThumbPos) / std::max(1, contentWidth - trackWidth);
+                thumbPos = std::max(1, std::min(trackWidth - thumbSize, thumbPos));
+            }
+            l.horizontalMaxThumb = maxThumbPos;
+            l.horizontalThumb = Rect(1 + thumbPos, h - 2, thumbSize, 1);
+        }
+    }
 }
 
 void Window::drawScrollbars(UnicodeBuffer& buffer) {
@@ -367,259 +521,110 @@ void Window::drawScrollbars(UnicodeBuffer& buffer) {
     std::string thumbColor = Color::WHITE + Color::BG_CYAN;
     std::string buttonColor = Color::BRIGHT_WHITE + Color::BG_BLUE;
     
-    // Calculate scrollbar needs without circular dependency
-    bool needsVert = needsVerticalScrollbar();
-    bool needsHoriz = needsHorizontalScrollbar();
+    const Layout& l = getLayout();
     
     // Vertical scrollbar (1 character before right border)
-    if (needsVert) {
-        int scrollbarX = x + w - 2;
-        int scrollbarHeight = h - 2 - (needsHoriz ? 1 : 0);
+    const Rect& vbar = l.verticalBar;
+    if (!vbar.empty()) {
+        int scrollbarX = x + vbar.x;
+        buffer.setCell(scrollbarX, y + vbar.y, Unicode::SCROLLBAR_BUTTON_UP, buttonColor);
+        buffer.setCell(scrollbarX, y + vbar.y + vbar.h - 1, Unicode::SCROLLBAR_BUTTON_DOWN, buttonColor);
+        buffer.drawVLine(scrollbarX, y + vbar.y + 1, vbar.h - 2, Unicode::SCROLLBAR_TRACK, trackColor);
         
-        // Bounds checking
-        if (scrollbarHeight > 2 && scrollbarX >= 0) {
-            // Draw up arrow button
-            buffer.setCell(scrollbarX, y + 1, Unicode::SCROLLBAR_BUTTON_UP, buttonColor);
-            
-            // Draw down arrow button
-            buffer.setCell(scrollbarX, y + scrollbarHeight, Unicode::SCROLLBAR_BUTTON_DOWN, buttonColor);
-            
-            // Draw scrollbar track (between arrow buttons)
-            int trackHeight = scrollbarHeight - 1;
-            for (int i = 1; i < trackHeight; i++) {
-                if (y + 1 + i >= 0) {
-                    buffer.setCell(scrollbarX, y + 1 + i, Unicode::SCROLLBAR_TRACK, trackColor);
-                }
-            }
-            
-            // Calculate thumb position and size with bounds checking
-            if (contentHeight > 0 && trackHeight > 1) {
-                int thumbSize = std::max(1, std::min(trackHeight - 1, (trackHeight * trackHeight) / contentHeight));
-                int maxThumbPos = trackHeight - 1 - thumbSize;
-                int thumbPos = 1; // Start after up button
-                
-                if (contentHeight > trackHeight && maxThumbPos > 0) {
-                    thumbPos = 1 + (scrollY * maxThumbPos) / std::max(1, contentHeight - trackHeight);
-                    thumbPos = std::max(1, std::min(trackHeight - thumbSize, thumbPos));
-                }
-                
-                // Draw thumb with bounds checking
-                for (int i = 0; i < thumbSize; i++) {
-                    if (y + 1 + thumbPos + i >= 0 && thumbPos + i < trackHeight) {
-                        buffer.setCell(scrollbarX, y + 1 + thumbPos + i, Unicode::SCROLLBAR_THUMB, thumbColor);
-                    }
-                }
-            }
-        }
+        const Rect& thumb = l.verticalThumb;
+        if (!thumb.empty()) buffer.drawVLine(x + thumb.x, y + thumb.y, thumb.h, Unicode::SCROLLBAR_THUMB, thumbColor);
     }
     
     // Horizontal scrollbar (1 character before bottom border)
-    if (needsHoriz) {
-        int scrollbarY = y + h - 2;
-        int scrollbarWidth = w - 2 - (needsVert ? 1 : 0);
+    const Rect& hbar = l.horizontalBar;
+    if (!hbar.empty()) {
+        int scrollbarY = y + hbar.y;
+        buffer.setCell(x + hbar.x, scrollbarY, Unicode::SCROLLBAR_BUTTON_LEFT, buttonColor);
+        buffer.setCell(x + hbar.x + hbar.w - 1, scrollbarY, Unicode::SCROLLBAR_BUTTON_RIGHT, buttonColor);
+        buffer.drawHLine(x + hbar.x + 1, scrollbarY, hbar.w - 2, Unicode::SCROLLBAR_TRACK, trackColor);
         
-        // Bounds checking
-        if (scrollbarWidth > 2 && scrollbarY >= 0) {
-            // Draw left arrow button
-            buffer.setCell(x + 1, scrollbarY, Unicode::SCROLLBAR_BUTTON_LEFT, buttonColor);
-            
-            // Draw right arrow button
-            buffer.setCell(x + scrollbarWidth, scrollbarY, Unicode::SCROLLBAR_BUTTON_RIGHT, buttonColor);
-            
-            // Draw scrollbar track (between arrow buttons)
-            int trackWidth = scrollbarWidth - 1;
-            for (int i = 1; i < trackWidth; i++) {
-                if (x + 1 + i >= 0) {
-                    buffer.setCell(x + 1 + i, scrollbarY, Unicode::SCROLLBAR_TRACK, trackColor);
-                }
-            }
-            
-            // Calculate thumb position and size with bounds checking
-            if (contentWidth > 0 && trackWidth > 1) {
-                int thumbSize = std::max(1, std::min(trackWidth - 1, (trackWidth * trackWidth) / contentWidth));
-                int maxThumbPos = trackWidth - 1 - thumbSize;
-                int thumbPos = 1; // Start after left button
-                
-                if (contentWidth > trackWidth && maxThumbPos > 0) {
-                    thumbPos = 1 + (scrollX * maxThumbPos) / std::max(1, contentWidth - trackWidth);
-                    thumbPos = std::max(1, std::min(trackWidth - thumbSize, thumbPos));
-                }
-                
-                // Draw thumb with bounds checking
-                for (int i = 0; i < thumbSize; i++) {
-                    if (x + 1 + thumbPos + i >= 0 && thumbPos + i < trackWidth) {
-                        buffer.setCell(x + 1 + thumbPos + i, scrollbarY, Unicode::SCROLLBAR_THUMB, thumbColor);
-                    }
-                }
-            }
-        }
+        const Rect& thumb = l.horizontalThumb;
+        if (!thumb.empty()) buffer.drawHLine(x + thumb.x, y + thumb.y, thumb.w, Unicode::SCROLLBAR_THUMB, thumbColor);
     }
 }
 
 // Scrollbar mouse interaction methods
 bool Window::verticalScrollbarContains(int mx, int my) const {
-    if (!needsVerticalScrollbar()) return false;
-    int scrollbarX = x + w - 2;
-    int scrollbarHeight = h - 2 - (needsHorizontalScrollbar() ? 1 : 0);
-    return mx == scrollbarX && my >= y + 1 && my <= y + scrollbarHeight;
+    return getLayout().verticalBar.contains(mx - x, my - y);
 }
 
 bool Window::horizontalScrollbarContains(int mx, int my) const {
-    if (!needsHorizontalScrollbar()) return false;
-    int scrollbarY = y + h - 2;
-    int scrollbarWidth = w - 2 - (needsVerticalScrollbar() ? 1 : 0);
-    return my == scrollbarY && mx >= x + 1 && mx <= x + scrollbarWidth;
+    return getLayout().horizontalBar.contains(mx - x, my - y);
 }
 
 bool Window::verticalThumbContains(int mx, int my) const {
-    if (!verticalScrollbarContains(mx, my)) return false;
-    
-    int scrollbarX = x + w - 2;
-    int scrollbarHeight = h - 2 - (needsHorizontalScrollbar() ? 1 : 0);
-    int trackHeight = scrollbarHeight - 1;
-    
-    if (contentHeight > 0 && trackHeight > 1) {
-        int thumbSize = std::max(1, std::min(trackHeight - 1, (trackHeight * trackHeight) / contentHeight));
-        int maxThumbPos = trackHeight - 1 - thumbSize;
-        int thumbPos = 1;
-        
-        if (contentHeight > trackHeight && maxThumbPos > 0) {
-            thumbPos = 1 + (scrollY * maxThumbPos) / std::max(1, contentHeight - trackHeight);
-            thumbPos = std::max(1, std::min(trackHeight - thumbSize, thumbPos));
-        }
-        
-        return my >= y + 1 + thumbPos && my < y + 1 + thumbPos + thumbSize;
-    }
-    return false;
+    return getLayout().verticalThumb.contains(mx - x, my - y);
 }
 
 bool Window::horizontalThumbContains(int mx, int my) const {
-    if (!horizontalScrollbarContains(mx, my)) return false;
-    
-    int scrollbarY = y + h - 2;
-    int scrollbarWidth = w - 2 - (needsVerticalScrollbar() ? 1 : 0);
-    int trackWidth = scrollbarWidth - 1;
-    
-    if (contentWidth > 0 && trackWidth > 1) {
-        int thumbSize = std::max(1, std::min(trackWidth - 1, (trackWidth * trackWidth) / contentWidth));
-        int maxThumbPos = trackWidth - 1 - thumbSize;
-        int thumbPos = 1;
-        
-        if (contentWidth > trackWidth && maxThumbPos > 0) {
-            thumbPos = 1 + (scrollX * maxThumbPos) / std::max(1, contentWidth - trackWidth);
-            thumbPos = std::max(1, std::min(trackWidth - thumbSize, thumbPos));
-        }
-        
-        return mx >= x + 1 + thumbPos && mx < x + 1 + thumbPos + thumbSize;
-    }
-    return false;
+    return getLayout().horizontalThumb.contains(mx - x, my - y);
 }
 
 void Window::handleScrollbarClick(int mx, int my) {
-    // Vertical scrollbar buttons
-    if (needsVerticalScrollbar()) {
-        int scrollbarX = x + w - 2;
-        if (mx == scrollbarX) {
-            if (my == y + 1) {
-                // Up button clicked
-                scrollUp();
-                return;
-            }
-            int scrollbarHeight = h - 2 - (needsHorizontalScrollbar() ? 1 : 0);
-            if (my == y + scrollbarHeight) {
-                // Down button clicked
-                scrollDown();
-                return;
-            }
-            
-            // Track clicked - page up/down
-            if (verticalScrollbarContains(mx, my) && !verticalThumbContains(mx, my)) {
-                int trackHeight = scrollbarHeight - 1;
-                int thumbPos = 1;
-                if (contentHeight > trackHeight) {
-                    thumbPos = 1 + (scrollY * (trackHeight - 1)) / std::max(1, contentHeight - trackHeight);
-                }
-                
-                if (my < y + 1 + thumbPos) {
-                    scrollUp(5); // Page up
-                } else {
-                    scrollDown(5); // Page down
-                }
-                return;
+    const Layout& l = getLayout();
+    int px = mx - x;
+    int py = my - y;
+    
+    // Vertical scrollbar: buttons at either end, page up/down on the track
+    if (l.verticalBar.contains(px, py)) {
+        const Rect& bar = l.verticalBar;
+        if (py == bar.y) {
+            scrollUp();
+        } else if (py == bar.y + bar.h - 1) {
+            scrollDown();
+        } else if (!l.verticalThumb.contains(px, py)) {
+            if (py < l.verticalThumb.y) {
+                scrollUp(5); // Page up
+            } else {
+                scrollDown(5); // Page down
             }
         }
+        return;
     }
     
-    // Horizontal scrollbar buttons
-    if (needsHorizontalScrollbar()) {
-        int scrollbarY = y + h - 2;
-        if (my == scrollbarY) {
-            if (mx == x + 1) {
-                // Left button clicked
-                scrollLeft();
-                return;
-            }
-            int scrollbarWidth = w - 2 - (needsVerticalScrollbar() ? 1 : 0);
-            if (mx == x + scrollbarWidth) {
-                // Right button clicked
-                scrollRight();
-                return;
-            }
-            
-            // Track clicked - page left/right
-            if (horizontalScrollbarContains(mx, my) && !horizontalThumbContains(mx, my)) {
-                int trackWidth = scrollbarWidth - 1;
-                int thumbPos = 1;
-                if (contentWidth > trackWidth) {
-                    thumbPos = 1 + (scrollX * (trackWidth - 1)) / std::max(1, contentWidth - trackWidth);
-                }
-                
-                if (mx < x + 1 + thumbPos) {
-                    scrollLeft(5); // Page left
-                } else {
-                    scrollRight(5); // Page right
-                }
-                return;
+    // Horizontal scrollbar: same for left/right
+    if (l.horizontalBar.contains(px, py)) {
+        const Rect& bar = l.horizontalBar;
+        if (px == bar.x) {
+            scrollLeft();
+        } else if (px == bar.x + bar.w - 1) {
+            scrollRight();
+        } else if (!l.horizontalThumb.contains(px, py)) {
+            if (px < l.horizontalThumb.x) {
+                scrollLeft(5); // Page left
+            } else {
+                scrollRight(5); // Page right
             }
         }
     }
 }
 
 void Window::handleScrollbarDrag(int mx, int my) {
+    // Moving the thumb to `thumbPos` maps back to the scroll offset that
+    // computeLayout() would place it at
+    const Layout& l = getLayout();
+    
     // Handle vertical thumb dragging
-    if (draggingVerticalThumb && needsVerticalScrollbar()) {
-        int scrollbarHeight = h - 2 - (needsHorizontalScrollbar() ? 1 : 0);
-        int trackHeight = scrollbarHeight - 1;
-        
-        if (trackHeight > 1) {
-            int thumbSize = std::max(1, std::min(trackHeight - 1, (trackHeight * trackHeight) / contentHeight));
-            int maxThumbPos = trackHeight - 1 - thumbSize;
-            int newThumbPos = (my - y - 1) - dragThumbOffset;
-            newThumbPos = std::max(1, std::min(maxThumbPos + 1, newThumbPos));
-            
-            if (maxThumbPos > 0) {
-                int newScrollY = ((newThumbPos - 1) * (contentHeight - trackHeight)) / maxThumbPos;
-                scrollY = std::max(0, std::min(contentHeight - trackHeight, newScrollY));
-            }
-        }
+    if (draggingVerticalThumb && l.verticalMaxThumb > 0) {
+        int trackHeight = l.verticalTrack;
+        int newThumbPos = (my - y - 1) - dragThumbOffset;
+        newThumbPos = std::max(1, std::min(l.verticalMaxThumb + 1, newThumbPos));
+        int newScrollY = ((newThumbPos - 1) * (contentHeight - trackHeight)) / l.verticalMaxThumb;
+        scrollY = std::max(0, std::min(contentHeight - trackHeight, newScrollY));
     }
     
     // Handle horizontal thumb dragging
-    if (draggingHorizontalThumb && needsHorizontalScrollbar()) {
-        int scrollbarWidth = w - 2 - (needsVerticalScrollbar() ? 1 : 0);
-        int trackWidth = scrollbarWidth - 1;
-        
-        if (trackWidth > 1) {
-            int thumbSize = std::max(1, std::min(trackWidth - 1, (trackWidth * trackWidth) / contentWidth));
-            int maxThumbPos = trackWidth - 1 - thumbSize;
-            int newThumbPos = (mx - x - 1) - dragThumbOffset;
-            newThumbPos = std::max(1, std::min(maxThumbPos + 1, newThumbPos));
-            
-            if (maxThumbPos > 0) {
-                int newScrollX = ((newThumbPos - 1) * (contentWidth - trackWidth)) / maxThumbPos;
-                scrollX = std::max(0, std::min(contentWidth - trackWidth, newScrollX));
-            }
-        }
+    if (draggingHorizontalThumb && l.horizontalMaxThumb > 0) {
+        int trackWidth = l.horizontalTrack;
+        int newThumbPos = (mx - x - 1) - dragThumbOffset;
+        newThumbPos = std::max(1, std::min(l.horizontalMaxThumb + 1, newThumbPos));
+        int newScrollX = ((newThumbPos - 1) * (contentWidth - trackWidth)) / l.horizontalMaxThumb;
+        scrollX = std::max(0, std::min(contentWidth - trackWidth, newScrollX));
     }
 }
 
@@ -628,6 +633,7 @@ void Window::addButton(std::shared_ptr<Button> button) {
     if (button) {
         button->setParentWindow(shared_from_this());
         buttons.push_back(button);
+        invalidate();
     }
 }
 
@@ -636,6 +642,7 @@ void Window::removeButton(std::shared_ptr<Button> button) {
     if (it != buttons.end()) {
         (*it)->setParentWindow(nullptr);
         buttons.erase(it);
+        invalidate();
     }
 }
 
@@ -644,6 +651,7 @@ void Window::clearButtons() {
         button->setParentWindow(nullptr);
     }
     buttons.clear();
+    invalidate();
 }
 
 std::shared_ptr<Button> Window::getButtonAt(int mx, int my) const {
@@ -665,15 +673,11 @@ int Window::getContentY() const {
 }
 
 int Window::getContentWidth() const {
-    int width = w - 2; // Account for left/right borders
-    if (needsVerticalScrollbar()) width--; // Account for scrollbar
-    return std::max(0, width);
+    return std::max(0, getLayout().content.w);
 }
 
 int Window::getContentHeight() const {
-    int height = h - 2; // Account for top/bottom borders
-    if (needsHorizontalScrollbar()) height--; // Account for scrollbar
-    return std::max(0, height);
+    return std::max(0, getLayout().content.h);
 }
 
 // Event generation methods
@@ -0,0 +1,201 @@
+#include "../include/window_manager.h"
+
+WindowManager::WindowManager() : topZ(0), bottomZ(0), count(0), live(0) {
+    for (List& list : lists) {
+        list.bottom = list.top = NIL;
+    }
+}
+
+WindowManager::Handle WindowManager::handleOf(uint32_t slot) const {
+    if (slot == NIL) return 0;
+    return (slots[slot].generation << SLOT_BITS) | (slot + 1);
+}
+
+uint32_t WindowManager::slotOf(Handle handle) const {
+    uint32_t slot = (handle & SLOT_MASK) - 1;
+    if ((handle & SLOT_MASK) == 0 || slot >= slots.size()) return NIL;
+    const Slot& s = slots[slot];
+    if (!s.window || (s.generation << SLOT_BITS) != (handle & ~SLOT_MASK)) return NIL;
+    return slot;
+}
+
+WindowManager::Handle WindowManager::step(Handle handle, int list, bool up) const {
+    uint32_t slot = slotOf(handle);
+    if (slot == NIL) return 0;
+    const Link& link = slots[slot].links[list];
+    return handleOf(up ? link.above : link.below);
+}
+
+void WindowManager::unlink(int list, uint32_t slot) {
+    Link& link = slots[slot].links[list];
+    if (link.below != NIL) slots[link.below].links[list].above = link.above;
+    else lists[list].bottom = link.above;
+    if (link.above != NIL) slots[link.above].links[list].below = link.below;
+    else lists[list].top = link.below;
+    link.below = link.above = NIL;
+}
+
+void WindowManager::linkAbove(int list, uint32_t slot, uint32_t below) {
+    Link& link = slots[slot].links[list];
+    link.below = below;
+    link.above = below != NIL ? slots[below].links[list].above : lists[list].bottom;
+    if (link.below != NIL) slots[link.below].links[list].above = slot;
+    else lists[list].bottom = slot;
+    if (link.above != NIL) slots[link.above].links[list].below = slot;
+    else lists[list].top = slot;
+}
+
+void WindowManager::evaluate(uint32_t slot) {
+    Slot& s = slots[slot];
+    bool onScreen = s.window->isVisible() && !s.window->getBounds().intersect(screen).empty();
+    if (onScreen == s.live) return;
+    
+    s.live = onScreen;
+    if (onScreen) {
+        // Keep the live list in stacking order: find the nearest live
+        // window below by walking down from the top, which only visits
+        // live windows
+        uint32_t below = lists[LIVE].top;
+        while (below != NIL && slots[below].z > s.z) {
+            below = slots[below].links[LIVE].below;
+        }
+        linkAbove(LIVE, slot, below);
+        live++;
+    } else {
+        unlink(LIVE, slot);
+        live--;
+        culled.push_back(s.window->id);
+    }
+}
+
+WindowManager::Handle WindowManager::add(std::shared_ptr<Window> window) {
+    if (!window) return 0;
+    
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        if (slots.size() >= SLOT_MASK) return 0;
+        slot = (uint32_t)slots.size();
+        slots.push_back(Slot());
+        slots[slot].generation = 0;
+    }
+    
+    Slot& s = slots[slot];
+    s.window = std::move(window);
+    s.z = ++topZ;
+    s.live = false;
+    s.links[ALL].below = s.links[ALL].above = NIL;
+    s.links[LIVE].below = s.links[LIVE].above = NIL;
+    linkAbove(ALL, slot, lists[ALL].top);
+    count++;
+    
+    Handle handle = handleOf(slot);
+    byId[s.window->id] = handle;
+    evaluate(slot);
+    return handle;
+}
+
+void WindowManager::remove(Handle handle) {
+    uint32_t slot = slotOf(handle);
+    if (slot == NIL) return;
+    
+    Slot& s = slots[slot];
+    unlink(ALL, slot);
+    if (s.live) {
+        unlink(LIVE, slot);
+        live--;
+    }
+    byId.erase(s.window->id);
+    s.window.reset();
+    s.generation = (s.generation + 1) & (0xffffffffu >> SLOT_BITS);
+    freeSlots.push_back(slot);
+    count--;
+}
+
+Window* WindowManager::get(Handle handle) const {
+    uint32_t slot = slotOf(handle);
+    return slot != NIL ? slots[slot].window.get() : nullptr;
+}
+
+WindowManager::Handle WindowManager::find(uint32_t windowId) const {
+    auto it = byId.find(windowId);
+    return it != byId.end() ? it->second : 0;
+}
+
+bool WindowManager::isLive(Handle handle) const {
+    uint32_t slot = slotOf(handle);
+    return slot != NIL && slots[slot].live;
+}
+
+void WindowManager::raise(Handle handle) {
+    uint32_t slot = slotOf(handle);
+    if (slot == NIL || slot == lists[ALL].top) return;
+    
+    Slot& s = slots[slot];
+    s.z = ++topZ;
+    unlink(ALL, slot);
+    linkAbove(ALL, slot, lists[ALL].top);
+    if (s.live) {
+        unlink(LIVE, slot);
+        linkAbove(LIVE, slot, lists[LIVE].top);
+    }
+}
+
+void WindowManager::lower(Handle handle) {
+    uint32_t slot = slotOf(handle);
+    if (slot == NIL || slot == lists[ALL].bottom) return;
+    
+    Slot& s = slots[slot];
+    s.z = --bottomZ;
+    unlink(ALL, slot);
+    linkAbove(ALL, slot, NIL);
+    if (s.live) {
+        unlink(LIVE, slot);
+        linkAbove(LIVE, slot, NIL);
+    }
+}
+
+void WindowManager::show(Handle handle) {
+    uint32_t slot = slotOf(handle);
+    if (slot == NIL) return;
+    slots[slot].window->show();
+    evaluate(slot);
+}
+
+void WindowManager::hide(Handle handle) {
+    uint32_t slot = slotOf(handle);
+    if (slot == NIL) return;
+    slots[slot].window->close();
+    evaluate(slot);
+}
+
+void WindowManager::refresh(Handle handle) {
+    uint32_t slot = slotOf(handle);
+    if (slot != NIL) evaluate(slot);
+}
+
+void WindowManager::refreshLive() {
+    uint32_t slot = lists[LIVE].bottom;
+    while (slot != NIL) {
+        uint32_t next = slots[slot].links[LIVE].above;
+        evaluate(slot);
+        slot = next;
+    }
+}
+
+void WindowManager::setScreen(int w, int h) {
+    Rect rect(0, 0, w, h);
+    if (rect == screen) return;
+    screen = rect;
+    
+    for (uint32_t slot = lists[ALL].bottom; slot != NIL; slot = slots[slot].links[ALL].above) {
+        evaluate(slot);
+    }
+}
+
+void WindowManager::takeCulled(std::vector<uint32_t>& ids) {
+    ids.insert(ids.end(), culled.begin(), culled.end());
+    culled.clear();
+}
@@ -0,0 +1,91 @@
+#include "../include/worker_pool.h"
+#include <algorithm>
+
+static const size_t MAX_WORKERS = 7;
+
+WorkerPool::WorkerPool()
+    : generation(0), stopping(false), task(nullptr), taskCount(0), nextTask(0), remaining(0) {
+    unsigned hardware = std::thread::hardware_concurrency();
+    size_t count = hardware > 1 ? std::min<size_t>(hardware - 1, MAX_WORKERS) : 0;
+    for (size_t i = 0; i < count; i++) {
+        workers.push_back(std::thread(&WorkerPool::workerLoop, this));
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+WorkerPool& WorkerPool::getInstance() {
+    static WorkerPool instance;
+    return instance;
+}
+
+void WorkerPool::workerLoop() {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) return;
+        seen = generation;
+        const std::function<void(size_t)>* fn = task;
+        size_t count = taskCount;
+        
+        lock.unlock();
+        runTasks(seen, *fn, count);
+        lock.lock();
+    }
+}
+
+void WorkerPool::runTasks(uint64_t job, const std::function<void(size_t)>& fn, size_t count) {
+    uint64_t tag = (job & 0xffffffffu) << 32;
+    uint64_t word = nextTask.load(std::memory_order_acquire);
+    for (;;) {
+        if ((word & ~(uint64_t)0xffffffffu) != tag || (word & 0xffffffffu) >= count) return;
+        if (!nextTask.compare_exchange_weak(word, word + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            continue;
+        }
+        fn((size_t)(word & 0xffffffffu));
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_all();
+        }
+        word = nextTask.load(std::memory_order_acquire);
+    }
+}
+
+void WorkerPool::parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) return;
+    if (workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; i++) {
+            fn(i);
+        }
+        return;
+    }
+    
+    std::lock_guard<std::mutex> job(jobMutex);
+    uint64_t current;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = ++generation;
+        task = &fn;
+        taskCount = count;
+        remaining.store(count, std::memory_order_relaxed);
+        nextTask.store((current & 0xffffffffu) << 32, std::memory_order_release);
+    }
+    wake.notify_all();
+    
+    runTasks(current, fn, count);
+    
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return remaining.load(std::memory_order_acquire) == 0; });
+    }
+}